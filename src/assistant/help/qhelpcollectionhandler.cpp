@@ -11,6 +11,7 @@
 #include <QtCore/qdatetime.h>
 #include <QtCore/qdir.h>
 #include <QtCore/qfileinfo.h>
+#include <QtCore/qhash.h>
 #include <QtCore/qmap.h>
 #include <QtCore/qtimer.h>
 #include <QtCore/qversionnumber.h>
@@ -83,6 +84,8 @@ void QHelpCollectionHandler::closeDB()
     if (!m_query)
         return;
 
+    invalidateLookupCaches();
+    m_cachedQueries.clear();
     m_query.reset();
     QSqlDatabase::removeDatabase(m_connectionName);
     m_connectionName.clear();
@@ -289,6 +292,8 @@ void QHelpCollectionHandler::execVacuum()
     if (!m_query)
         return;
 
+    // VACUUM fails while other statements of the connection are pending.
+    m_cachedQueries.clear();
     m_query->exec("VACUUM"_L1);
     m_vacuumScheduled = false;
 }
@@ -662,6 +667,7 @@ bool QHelpCollectionHandler::setFilterData(const QString &filterName,
 
 bool QHelpCollectionHandler::removeFilter(const QString &filterName)
 {
+    invalidateLookupCaches();
     m_query->prepare("SELECT FilterId FROM Filter WHERE Name = ?"_L1);
     m_query->bindValue(0, filterName);
     if (!m_query->exec())
@@ -885,6 +891,7 @@ bool QHelpCollectionHandler::unregisterDocumentation(const QString &namespaceNam
 
     const int nsId = m_query->value(0).toInt();
 
+    invalidateLookupCaches();
     m_query->prepare("DELETE FROM NamespaceTable WHERE Id = ?"_L1);
     m_query->bindValue(0, nsId);
     if (!m_query->exec())
@@ -938,34 +945,114 @@ static QHelpCollectionHandler::FileInfo extractFileInfo(const QUrl &url)
     return fileInfo;
 }
 
-bool QHelpCollectionHandler::fileExists(const QUrl &url) const
+QSqlQuery *QHelpCollectionHandler::cachedQuery(const QString &statement) const
 {
-    if (!isDBOpened())
-        return false;
+    auto it = m_cachedQueries.find(statement);
+    if (it == m_cachedQueries.end()) {
+        auto query = std::make_unique<QSqlQuery>(QSqlDatabase::database(m_connectionName));
+        query->setForwardOnly(true);
+        if (!query->prepare(statement))
+            return nullptr;
+        it = m_cachedQueries.emplace(statement, std::move(query)).first;
+    }
+    return it->second.get();
+}
 
-    const FileInfo fileInfo = extractFileInfo(url);
-    if (fileInfo.namespaceName.isEmpty())
-        return false;
+void QHelpCollectionHandler::invalidateLookupCaches()
+{
+    m_fileNamespaces.clear();
+    m_namespaceVersions.clear();
+    m_filterNamespaces.clear();
+    m_lookupCachesValid = false;
+}
 
-    m_query->prepare(
-        "SELECT COUNT (DISTINCT NamespaceTable.Id) "
+void QHelpCollectionHandler::ensureLookupCaches() const
+{
+    if (m_lookupCachesValid || !m_query)
+        return;
+
+    QSqlQuery *query = cachedQuery(
+        "SELECT "
+            "FolderTable.Name, "
+            "FileNameTable.Name, "
+            "NamespaceTable.Name "
         "FROM "
             "FileNameTable, "
             "NamespaceTable, "
             "FolderTable "
-        "WHERE FolderTable.Name = ? "
-        "AND FileNameTable.Name = ? "
-        "AND FileNameTable.FolderId = FolderTable.Id "
+        "WHERE FileNameTable.FolderId = FolderTable.Id "
         "AND FolderTable.NamespaceId = NamespaceTable.Id"_L1);
-    m_query->bindValue(0, fileInfo.folderName);
-    m_query->bindValue(1, fileInfo.fileName);
-    if (!m_query->exec() || !m_query->next())
+    if (!query || !query->exec())
+        return;
+
+    while (query->next()) {
+        // Folder names never contain a slash, see extractFileInfo().
+        QStringList &namespaces = m_fileNamespaces[query->value(0).toString() + u'/'
+                                                   + query->value(1).toString()];
+        const QString namespaceName = query->value(2).toString();
+        if (!namespaces.contains(namespaceName))
+            namespaces.append(namespaceName);
+    }
+    query->finish();
+
+    query = cachedQuery(
+        "SELECT "
+            "NamespaceTable.Name, "
+            "VersionTable.Version "
+        "FROM "
+            "NamespaceTable, "
+            "VersionTable "
+        "WHERE NamespaceTable.Id = VersionTable.NamespaceId"_L1);
+    if (!query || !query->exec())
+        return;
+
+    while (query->next()) {
+        const QString namespaceName = query->value(0).toString();
+        if (!m_namespaceVersions.contains(namespaceName))
+            m_namespaceVersions.insert(namespaceName, query->value(1).toString());
+    }
+    query->finish();
+
+    m_lookupCachesValid = true;
+}
+
+QStringList QHelpCollectionHandler::namespacesForFile(const FileInfo &fileInfo) const
+{
+    ensureLookupCaches();
+    return m_fileNamespaces.value(fileInfo.folderName + u'/' + fileInfo.fileName);
+}
+
+QString QHelpCollectionHandler::bestNamespaceForFile(const FileInfo &fileInfo,
+                                                     const QStringList &namespaceList) const
+{
+    if (namespaceList.isEmpty())
+        return {};
+
+    if (namespaceList.contains(fileInfo.namespaceName))
+        return fileInfo.namespaceName;
+
+    const QString originalVersion = namespaceVersion(fileInfo.namespaceName);
+
+    for (const QString &ns : namespaceList) {
+        const QString nsVersion = namespaceVersion(ns);
+        if (originalVersion == nsVersion)
+            return ns;
+    }
+
+    // TODO: still, we may like to return the ns for the highest available version
+    return namespaceList.first();
+}
+
+bool QHelpCollectionHandler::fileExists(const QUrl &url) const
+{
+    if (!isDBOpened())
         return false;
 
-    const int count = m_query->value(0).toInt();
-    m_query->clear();
+    const FileInfo fileInfo = extractFileInfo(url);
+    if (fileInfo.namespaceName.isEmpty())
+        return false;
 
-    return count;
+    return !namespacesForFile(fileInfo).isEmpty();
 }
 
 static QString prepareFilterQuery(const QString &filterName)
@@ -1093,6 +1180,10 @@ QString QHelpCollectionHandler::namespaceForFile(const QUrl &url,
     if (fileInfo.namespaceName.isEmpty())
         return {};
 
+    const QStringList candidates = namespacesForFile(fileInfo);
+    if (candidates.isEmpty() || filterAttributes.isEmpty())
+        return bestNamespaceForFile(fileInfo, candidates);
+
     const QString filterlessQuery =
         "SELECT DISTINCT "
             "NamespaceTable.Name "
@@ -1109,34 +1200,23 @@ QString QHelpCollectionHandler::namespaceForFile(const QUrl &url,
             + prepareFilterQuery(filterAttributes.size(), "FileNameTable"_L1, "FileId"_L1,
                                  "FileFilterTable"_L1, "FileId"_L1);
 
-    m_query->prepare(filterQuery);
-    m_query->bindValue(0, fileInfo.folderName);
-    m_query->bindValue(1, fileInfo.fileName);
-    bindFilterQuery(m_query.get(), 2, filterAttributes);
-
-    if (!m_query->exec())
+    QSqlQuery *query = cachedQuery(filterQuery);
+    if (!query)
         return {};
 
-    QStringList namespaceList;
-    while (m_query->next())
-        namespaceList.append(m_query->value(0).toString());
+    query->bindValue(0, fileInfo.folderName);
+    query->bindValue(1, fileInfo.fileName);
+    bindFilterQuery(query, 2, filterAttributes);
 
-    if (namespaceList.isEmpty())
+    if (!query->exec())
         return {};
 
-    if (namespaceList.contains(fileInfo.namespaceName))
-        return fileInfo.namespaceName;
-
-    const QString originalVersion = namespaceVersion(fileInfo.namespaceName);
-
-    for (const QString &ns : namespaceList) {
-        const QString nsVersion = namespaceVersion(ns);
-        if (originalVersion == nsVersion)
-            return ns;
-    }
+    QStringList namespaceList;
+    while (query->next())
+        namespaceList.append(query->value(0).toString());
+    query->finish();
 
-    // TODO: still, we may like to return the ns for the highest available version
-    return namespaceList.first();
+    return bestNamespaceForFile(fileInfo, namespaceList);
 }
 
 QString QHelpCollectionHandler::namespaceForFile(const QUrl &url,
@@ -1149,49 +1229,18 @@ QString QHelpCollectionHandler::namespaceForFile(const QUrl &url,
     if (fileInfo.namespaceName.isEmpty())
         return {};
 
-    const QString filterlessQuery =
-        "SELECT DISTINCT "
-            "NamespaceTable.Name "
-        "FROM "
-            "FileNameTable, "
-            "NamespaceTable, "
-            "FolderTable "
-        "WHERE FolderTable.Name = ? "
-        "AND FileNameTable.Name = ? "
-        "AND FileNameTable.FolderId = FolderTable.Id "
-        "AND FolderTable.NamespaceId = NamespaceTable.Id"_L1;
-
-    const QString filterQuery = filterlessQuery
-            + prepareFilterQuery(filterName);
-
-    m_query->prepare(filterQuery);
-    m_query->bindValue(0, fileInfo.folderName);
-    m_query->bindValue(1, fileInfo.fileName);
-    bindFilterQuery(m_query.get(), 2, filterName);
-
-    if (!m_query->exec())
-        return {};
-
-    QStringList namespaceList;
-    while (m_query->next())
-        namespaceList.append(m_query->value(0).toString());
-
-    if (namespaceList.isEmpty())
-        return {};
-
-    if (namespaceList.contains(fileInfo.namespaceName))
-        return fileInfo.namespaceName;
-
-    const QString originalVersion = namespaceVersion(fileInfo.namespaceName);
-
-    for (const QString &ns : namespaceList) {
-        const QString nsVersion = namespaceVersion(ns);
-        if (originalVersion == nsVersion)
-            return ns;
+    QStringList namespaceList = namespacesForFile(fileInfo);
+    if (!namespaceList.isEmpty() && !filterName.isEmpty()) {
+        auto it = m_filterNamespaces.constFind(filterName);
+        if (it == m_filterNamespaces.cend())
+            it = m_filterNamespaces.insert(filterName, namespacesForFilter(filterName));
+        const QStringList &filterNamespaces = it.value();
+        namespaceList.removeIf([&filterNamespaces](const QString &ns) {
+            return !filterNamespaces.contains(ns);
+        });
     }
 
-    // TODO: still, we may like to return the ns for the highest available version
-    return namespaceList.first();
+    return bestNamespaceForFile(fileInfo, namespaceList);
 }
 
 QStringList QHelpCollectionHandler::files(const QString &namespaceName,
@@ -1219,21 +1268,25 @@ QStringList QHelpCollectionHandler::files(const QString &namespaceName,
             + prepareFilterQuery(filterAttributes.size(), "FileNameTable"_L1, "FileId"_L1,
                                  "FileFilterTable"_L1, "FileId"_L1);
 
-    m_query->prepare(filterQuery);
-    m_query->bindValue(0, namespaceName);
+    QSqlQuery *query = cachedQuery(filterQuery);
+    if (!query)
+        return {};
+
+    query->bindValue(0, namespaceName);
     int bindCount = 1;
     if (!extensionFilter.isEmpty()) {
-        m_query->bindValue(bindCount, "%.%1"_L1.arg(extensionFilter));
+        query->bindValue(bindCount, "%.%1"_L1.arg(extensionFilter));
         ++bindCount;
     }
-    bindFilterQuery(m_query.get(), bindCount, filterAttributes);
+    bindFilterQuery(query, bindCount, filterAttributes);
 
-    if (!m_query->exec())
+    if (!query->exec())
         return {};
 
     QStringList fileNames;
-    while (m_query->next())
-        fileNames.append(m_query->value(0).toString() + u'/' + m_query->value(1).toString());
+    while (query->next())
+        fileNames.append(query->value(0).toString() + u'/' + query->value(1).toString());
+    query->finish();
     return fileNames;
 }
 
@@ -1261,22 +1314,26 @@ QStringList QHelpCollectionHandler::files(const QString &namespaceName,
     const QString filterQuery = filterlessQuery
             + prepareFilterQuery(filterName);
 
-    m_query->prepare(filterQuery);
-    m_query->bindValue(0, namespaceName);
+    QSqlQuery *query = cachedQuery(filterQuery);
+    if (!query)
+        return {};
+
+    query->bindValue(0, namespaceName);
     int bindCount = 1;
     if (!extensionFilter.isEmpty()) {
-        m_query->bindValue(bindCount, "%.%1"_L1.arg(extensionFilter));
+        query->bindValue(bindCount, "%.%1"_L1.arg(extensionFilter));
         ++bindCount;
     }
 
-    bindFilterQuery(m_query.get(), bindCount, filterName);
+    bindFilterQuery(query, bindCount, filterName);
 
-    if (!m_query->exec())
-        return{};
+    if (!query->exec())
+        return {};
 
     QStringList fileNames;
-    while (m_query->next())
-        fileNames.append(m_query->value(0).toString() + u'/' + m_query->value(1).toString());
+    while (query->next())
+        fileNames.append(query->value(0).toString() + u'/' + query->value(1).toString());
+    query->finish();
     return fileNames;
 }
 
@@ -1417,8 +1474,59 @@ static QString getTitle(const QByteArray &contents)
     return title;
 }
 
+// Collects the rows of an executed contents query (namespace, folder, contents id
+// and version). The Data of the contents listed in knownTitles, which the caller
+// has decoded already, is not read; their contentsList entry stays empty.
+QList<QHelpCollectionHandler::ContentsData> QHelpCollectionHandler::readContents(
+        const QHash<int, QString> &knownTitles) const
+{
+    QMap<QString, QMap<QVersionNumber, ContentsData>> contentsMap;
+
+    while (m_query->next()) {
+        const QString namespaceName = m_query->value(0).toString();
+        const int contentsId = m_query->value(2).toInt();
+        const QString versionString = m_query->value(3).toString();
+
+        QByteArray contents;
+        QString title;
+        const auto it = knownTitles.constFind(contentsId);
+        if (it != knownTitles.cend()) {
+            title = it.value();
+        } else {
+            QSqlQuery *query = cachedQuery("SELECT Data FROM ContentsTable WHERE Id = ?"_L1);
+            if (!query)
+                continue;
+            query->bindValue(0, contentsId);
+            if (query->exec() && query->next())
+                contents = query->value(0).toByteArray();
+            query->finish();
+            title = getTitle(contents);
+        }
+
+        const QVersionNumber version = QVersionNumber::fromString(versionString);
+        // get existing or insert a new one otherwise
+        ContentsData &contentsData = contentsMap[title][version];
+        contentsData.namespaceName = namespaceName;
+        contentsData.folderName = m_query->value(1).toString();
+        contentsData.contentsIds.append(contentsId);
+        contentsData.contentsList.append(contents);
+    }
+
+    QList<QHelpCollectionHandler::ContentsData> result;
+    for (const auto &versionContents : std::as_const(contentsMap)) {
+        // insert items in the reverse order of version number
+        const auto itBegin = versionContents.constBegin();
+        auto it = versionContents.constEnd();
+        while (it != itBegin) {
+            --it;
+            result.append(it.value());
+        }
+    }
+    return result;
+}
+
 QList<QHelpCollectionHandler::ContentsData> QHelpCollectionHandler::contentsForFilter(
-        const QStringList &filterAttributes) const
+        const QStringList &filterAttributes, const QHash<int, QString> &knownTitles) const
 {
     if (!isDBOpened())
         return {};
@@ -1427,7 +1535,7 @@ QList<QHelpCollectionHandler::ContentsData> QHelpCollectionHandler::contentsForF
         "SELECT DISTINCT "
             "NamespaceTable.Name, "
             "FolderTable.Name, "
-            "ContentsTable.Data, "
+            "ContentsTable.Id, "
             "VersionTable.Version "
         "FROM "
             "FolderTable, "
@@ -1448,36 +1556,11 @@ QList<QHelpCollectionHandler::ContentsData> QHelpCollectionHandler::contentsForF
 
     m_query->exec();
 
-    QMap<QString, QMap<QVersionNumber, ContentsData>> contentsMap;
-
-    while (m_query->next()) {
-        const QString namespaceName = m_query->value(0).toString();
-        const QByteArray contents = m_query->value(2).toByteArray();
-        const QString versionString = m_query->value(3).toString();
-
-        const QString title = getTitle(contents);
-        const QVersionNumber version = QVersionNumber::fromString(versionString);
-        // get existing or insert a new one otherwise
-        ContentsData &contentsData = contentsMap[title][version];
-        contentsData.namespaceName = namespaceName;
-        contentsData.folderName = m_query->value(1).toString();
-        contentsData.contentsList.append(contents);
-    }
-
-    QList<QHelpCollectionHandler::ContentsData> result;
-    for (const auto &versionContents : std::as_const(contentsMap)) {
-        // insert items in the reverse order of version number
-        const auto itBegin = versionContents.constBegin();
-        auto it = versionContents.constEnd();
-        while (it != itBegin) {
-            --it;
-            result.append(it.value());
-        }
-    }
-    return result;
+    return readContents(knownTitles);
 }
 
-QList<QHelpCollectionHandler::ContentsData> QHelpCollectionHandler::contentsForFilter(const QString &filterName) const
+QList<QHelpCollectionHandler::ContentsData> QHelpCollectionHandler::contentsForFilter(
+        const QString &filterName, const QHash<int, QString> &knownTitles) const
 {
     if (!isDBOpened())
         return {};
@@ -1486,7 +1569,7 @@ QList<QHelpCollectionHandler::ContentsData> QHelpCollectionHandler::contentsForF
         "SELECT DISTINCT "
             "NamespaceTable.Name, "
             "FolderTable.Name, "
-            "ContentsTable.Data, "
+            "ContentsTable.Id, "
             "VersionTable.Version "
         "FROM "
             "FolderTable, "
@@ -1505,33 +1588,7 @@ QList<QHelpCollectionHandler::ContentsData> QHelpCollectionHandler::contentsForF
 
     m_query->exec();
 
-    QMap<QString, QMap<QVersionNumber, ContentsData>> contentsMap;
-
-    while (m_query->next()) {
-        const QString namespaceName = m_query->value(0).toString();
-        const QByteArray contents = m_query->value(2).toByteArray();
-        const QString versionString = m_query->value(3).toString();
-
-        const QString title = getTitle(contents);
-        const QVersionNumber version = QVersionNumber::fromString(versionString);
-        // get existing or insert a new one otherwise
-        ContentsData &contentsData = contentsMap[title][version];
-        contentsData.namespaceName = namespaceName;
-        contentsData.folderName = m_query->value(1).toString();
-        contentsData.contentsList.append(contents);
-    }
-
-    QList<QHelpCollectionHandler::ContentsData> result;
-    for (const auto &versionContents : std::as_const(contentsMap)) {
-        // insert items in the reverse order of version number
-        const auto itBegin = versionContents.constBegin();
-        auto it = versionContents.constEnd();
-        while (it != itBegin) {
-            --it;
-            result.append(it.value());
-        }
-    }
-    return result;
+    return readContents(knownTitles);
 }
 
 bool QHelpCollectionHandler::removeCustomValue(const QString &key)
@@ -1730,21 +1787,8 @@ QString QHelpCollectionHandler::namespaceVersion(const QString &namespaceName) c
     if (!m_query)
         return {};
 
-    m_query->prepare(
-        "SELECT "
-            "VersionTable.Version "
-        "FROM "
-            "NamespaceTable, "
-            "VersionTable "
-        "WHERE NamespaceTable.Name = ? "
-        "AND NamespaceTable.Id = VersionTable.NamespaceId"_L1);
-    m_query->bindValue(0, namespaceName);
-    if (!m_query->exec() || !m_query->next())
-        return {};
-
-    const QString ret = m_query->value(0).toString();
-    m_query->clear();
-    return ret;
+    ensureLookupCaches();
+    return m_namespaceVersions.value(namespaceName);
 }
 
 int QHelpCollectionHandler::registerNamespace(const QString &nspace, const QString &fileName)
@@ -1763,6 +1807,7 @@ int QHelpCollectionHandler::registerNamespace(const QString &nspace, const QStri
         }
     }
 
+    invalidateLookupCaches();
     QFileInfo fi(m_collectionFile);
     m_query->prepare("INSERT INTO NamespaceTable VALUES(NULL, ?, ?)"_L1);
     m_query->bindValue(0, nspace);
@@ -1784,6 +1829,7 @@ int QHelpCollectionHandler::registerVirtualFolder(const QString &folderName, int
     if (!m_query)
         return false;
 
+    invalidateLookupCaches();
     m_query->prepare("INSERT INTO FolderTable VALUES(NULL, ?, ?)"_L1);
     m_query->bindValue(0, namespaceId);
     m_query->bindValue(1, folderName);
@@ -1804,6 +1850,7 @@ int QHelpCollectionHandler::registerVirtualFolder(const QString &folderName, int
 
 int QHelpCollectionHandler::registerComponent(const QString &componentName, int namespaceId)
 {
+    invalidateLookupCaches();
     m_query->prepare("SELECT ComponentId FROM ComponentTable WHERE Name = ?"_L1);
     m_query->bindValue(0, componentName);
     if (!m_query->exec())
@@ -1837,6 +1884,7 @@ bool QHelpCollectionHandler::registerVersion(const QString &version, int namespa
     if (!m_query)
         return false;
 
+    invalidateLookupCaches();
     m_query->prepare("INSERT INTO VersionTable (NamespaceId, Version) VALUES(?, ?)"_L1);
     m_query->addBindValue(namespaceId);
     m_query->addBindValue(version);
@@ -1907,6 +1955,7 @@ void QHelpCollectionHandler::createVersionFilter(const QString &version)
 bool QHelpCollectionHandler::registerIndexTable(const QHelpDBReader::IndexTable &indexTable,
                                                 int nsId, int vfId, const QString &fileName)
 {
+    invalidateLookupCaches();
     Transaction transaction(m_connectionName);
 
     QMap<QString, QVariantList> filterAttributeToNewFileId;
@@ -2123,6 +2172,7 @@ bool QHelpCollectionHandler::registerIndexTable(const QHelpDBReader::IndexTable
 
 bool QHelpCollectionHandler::unregisterIndexTable(int nsId, int vfId)
 {
+    invalidateLookupCaches();
     m_query->prepare("DELETE FROM IndexFilterTable WHERE IndexId IN "
                          "(SELECT Id FROM IndexTable WHERE NamespaceId = ?)"_L1);
     m_query->bindValue(0, nsId);
@@ -18,14 +18,19 @@
 #include "qhelpdbreader_p.h"
 #include "qhelplink.h"
 
+#include <QtSql/qsqlquery.h>
+
 #include <QtCore/qdatetime.h>
+#include <QtCore/qhash.h>
 #include <QtCore/qobject.h>
 #include <QtCore/qstringlist.h>
 
+#include <memory>
+#include <unordered_map>
+
 QT_BEGIN_NAMESPACE
 
 class QHelpFilterData;
-class QSqlQuery;
 class QVariant;
 class QVersionNumber;
 
@@ -55,6 +60,8 @@ public:
     {
         QString namespaceName;
         QString folderName;
+        // ContentsTable ids, parallel to contentsList
+        QList<int> contentsIds;
         QList<QByteArray> contentsList;
     };
 
@@ -93,7 +100,8 @@ public:
     QStringList indicesForFilter(const QStringList &filterAttributes) const;
 
     // use contentsForFilter(const QString &) instead
-    QList<ContentsData> contentsForFilter(const QStringList &filterAttributes) const;
+    QList<ContentsData> contentsForFilter(const QStringList &filterAttributes,
+                                          const QHash<int, QString> &knownTitles = {}) const;
 
     // use QHelpFilterEngine::activeFilter() and filterData(const QString &) instead;
     QStringList filterAttributes() const;
@@ -130,7 +138,8 @@ public:
     QByteArray fileData(const QUrl &url) const;
 
     QStringList indicesForFilter(const QString &filterName) const;
-    QList<ContentsData> contentsForFilter(const QString &filterName) const;
+    QList<ContentsData> contentsForFilter(const QString &filterName,
+                                          const QHash<int, QString> &knownTitles = {}) const;
 
     bool removeCustomValue(const QString &key);
     QVariant customValue(const QString &key, const QVariant &defaultValue) const;
@@ -165,6 +174,13 @@ private:
                                        const QStringList &filterAttributes) const;
 
     QString namespaceVersion(const QString &namespaceName) const;
+    QSqlQuery *cachedQuery(const QString &statement) const;
+    QList<ContentsData> readContents(const QHash<int, QString> &knownTitles) const;
+    void invalidateLookupCaches();
+    void ensureLookupCaches() const;
+    QStringList namespacesForFile(const FileInfo &fileInfo) const;
+    QString bestNamespaceForFile(const FileInfo &fileInfo,
+                                 const QStringList &namespaceList) const;
     QMultiMap<QString, QUrl> linksForField(const QString &fieldName, const QString &fieldValue,
                                            const QString &filterName) const;
     QList<QHelpLink> documentsForField(const QString &fieldName,
@@ -192,6 +208,13 @@ private:
     QString m_collectionFile;
     QString m_connectionName;
     std::unique_ptr<QSqlQuery> m_query;
+    // Prepared statements of the hot lookup paths, keyed by their SQL.
+    mutable std::unordered_map<QString, std::unique_ptr<QSqlQuery>> m_cachedQueries;
+    // "folder/file" to the namespaces providing that file.
+    mutable QHash<QString, QStringList> m_fileNamespaces;
+    mutable QHash<QString, QString> m_namespaceVersions;
+    mutable QHash<QString, QStringList> m_filterNamespaces;
+    mutable bool m_lookupCachesValid = false;
     bool m_vacuumScheduled = false;
     bool m_readOnly = true;
 };
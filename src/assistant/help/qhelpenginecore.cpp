@@ -9,6 +9,8 @@
 
 #if QT_CONFIG(future)
 #include <QtConcurrent/qtconcurrentrun.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
 #include <QtCore/qpromise.h>
 #endif
 
@@ -19,6 +21,38 @@ QT_BEGIN_NAMESPACE
 
 using namespace Qt::StringLiterals;
 
+#if QT_CONFIG(future)
+// Keeps the decoded form of the contents blobs, keyed by their ContentsTable id,
+// so that switching between filters only needs to assemble the trees instead of
+// reading and decoding the blobs and building the urls again. The ids are stable
+// until documentation is registered or unregistered, which clears the cache;
+// requests started before that do not store their entries anymore.
+// The cache is shared by all content requests of one engine, which may run
+// concurrently in the thread pool.
+class QHelpContentsCache
+{
+public:
+    struct Entry
+    {
+        int depth = 0;
+        QString title;
+        QUrl url;
+    };
+    using Entries = std::shared_ptr<const QList<Entry>>;
+    using Snapshot = QHash<int, Entries>;
+
+    Snapshot snapshot(quint64 *generation);
+    Entries insert(quint64 generation, int contentsId, const QString &namespaceName,
+                   const QString &folderName, const QByteArray &contents);
+    void clear();
+
+private:
+    QMutex m_mutex;
+    Snapshot m_entries;
+    quint64 m_generation = 0;
+};
+#endif
+
 class QHelpEngineCorePrivate
 {
 public:
@@ -35,6 +69,9 @@ public:
     bool autoSaveFilter = true;
     bool usesFilterEngine = false;
     bool readOnly = true;
+#if QT_CONFIG(future)
+    std::shared_ptr<QHelpContentsCache> contentsCache = std::make_shared<QHelpContentsCache>();
+#endif
 
     QHelpEngineCore *q;
 };
@@ -54,6 +91,9 @@ void QHelpEngineCorePrivate::init(const QString &collectionFile)
                      [this](const QString &msg) { error = msg; });
     filterEngine->setCollectionHandler(collectionHandler.get());
     needsSetup = true;
+#if QT_CONFIG(future)
+    contentsCache->clear();
+#endif
 }
 
 bool QHelpEngineCorePrivate::setup()
@@ -312,6 +352,9 @@ bool QHelpEngineCore::registerDocumentation(const QString &documentationFileName
 {
     d->error.clear();
     d->needsSetup = true;
+#if QT_CONFIG(future)
+    d->contentsCache->clear();
+#endif
     return d->collectionHandler->registerDocumentation(documentationFileName);
 }
 
@@ -326,6 +369,9 @@ bool QHelpEngineCore::unregisterDocumentation(const QString &namespaceName)
 {
     d->error.clear();
     d->needsSetup = true;
+#if QT_CONFIG(future)
+    d->contentsCache->clear();
+#endif
     return d->collectionHandler->unregisterDocumentation(namespaceName);
 }
 
@@ -789,7 +835,8 @@ static QUrl constructUrl(const QString &namespaceName, const QString &folderName
 }
 
 using ContentProviderResult = QList<QHelpCollectionHandler::ContentsData>;
-using ContentProvider = std::function<ContentProviderResult(const QString &)>;
+using ContentProvider =
+        std::function<ContentProviderResult(const QString &, const QHash<int, QString> &)>;
 using ContentResult = std::shared_ptr<QHelpContentItem>;
 
 // This trick is needed because the c'tor of QHelpContentItem is private.
@@ -799,31 +846,82 @@ QHelpContentItem *createContentItem(const QString &name = {}, const QUrl &link =
     return new QHelpContentItem(name, link, parent);
 }
 
+QHelpContentsCache::Snapshot QHelpContentsCache::snapshot(quint64 *generation)
+{
+    QMutexLocker locker(&m_mutex);
+    *generation = m_generation;
+    return m_entries;
+}
+
+QHelpContentsCache::Entries QHelpContentsCache::insert(quint64 generation, int contentsId,
+                                                      const QString &namespaceName,
+                                                      const QString &folderName,
+                                                      const QByteArray &contents)
+{
+    QList<Entry> entries;
+    QDataStream s(contents);
+    while (true) {
+        Entry entry;
+        QString link;
+        s >> entry.depth;
+        s >> link;
+        s >> entry.title;
+        if (entry.title.isEmpty())
+            break;
+        entry.url = constructUrl(namespaceName, folderName, link);
+        entries.append(std::move(entry));
+    }
+
+    auto result = std::make_shared<const QList<Entry>>(std::move(entries));
+    QMutexLocker locker(&m_mutex);
+    if (generation == m_generation)
+        m_entries.insert(contentsId, result);
+    return result;
+}
+
+void QHelpContentsCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    ++m_generation;
+}
+
 static void requestContentHelper(QPromise<ContentResult> &promise, const ContentProvider &provider,
-                                 const QString &collectionFile)
+                                 const QString &collectionFile,
+                                 const std::shared_ptr<QHelpContentsCache> &cache)
 {
+    // Only the contents that are not cached yet are read from the collection,
+    // the others are identified by their id and title, which orders them.
+    quint64 generation = 0;
+    const QHelpContentsCache::Snapshot cached = cache->snapshot(&generation);
+    QHash<int, QString> knownTitles;
+    knownTitles.reserve(cached.size());
+    for (auto it = cached.cbegin(); it != cached.cend(); ++it) {
+        const QList<QHelpContentsCache::Entry> &entries = *it.value();
+        knownTitles.insert(it.key(), entries.isEmpty() ? QString() : entries.constFirst().title);
+    }
+
     ContentResult rootItem(createContentItem());
-    const ContentProviderResult result = provider(collectionFile);
+    const ContentProviderResult result = provider(collectionFile, knownTitles);
     for (const auto &contentsData : result) {
         const QString namespaceName = contentsData.namespaceName;
         const QString folderName = contentsData.folderName;
-        for (const QByteArray &contents : contentsData.contentsList) {
+        for (qsizetype i = 0; i < contentsData.contentsIds.size(); ++i) {
             if (promise.isCanceled())
                 return;
 
-            if (contents.isEmpty())
-                continue;
-
+            const int contentsId = contentsData.contentsIds.at(i);
+            QHelpContentsCache::Entries entries = cached.value(contentsId);
+            if (!entries) {
+                const QByteArray &contents = contentsData.contentsList.at(i);
+                if (contents.isEmpty())
+                    continue;
+                entries = cache->insert(generation, contentsId, namespaceName, folderName,
+                                        contents);
+            }
             QList<QHelpContentItem *> stack;
-            QDataStream s(contents);
-            while (true) {
-                int depth = 0;
-                QString link, title;
-                s >> depth;
-                s >> link;
-                s >> title;
-                if (title.isEmpty())
-                    break;
+            for (const QHelpContentsCache::Entry &entry : *entries) {
+                const int depth = entry.depth;
 
 // The example input (depth, link, title):
 //
@@ -854,9 +952,8 @@ static void requestContentHelper(QPromise<ContentResult> &promise, const Content
                         stack.append(substituteItem);
                 }
 
-                const QUrl url = constructUrl(namespaceName, folderName, link);
                 QHelpContentItem *parent = stack.isEmpty() ? rootItem.get() : stack.constLast();
-                stack.push_back(createContentItem(title, url, parent));
+                stack.push_back(createContentItem(entry.title, entry.url, parent));
             }
         }
     }
@@ -865,21 +962,23 @@ static void requestContentHelper(QPromise<ContentResult> &promise, const Content
 
 static ContentProvider contentProviderFromFilterEngine(const QString &filter)
 {
-    return [filter](const QString &collectionFile) -> ContentProviderResult {
+    return [filter](const QString &collectionFile,
+                const QHash<int, QString> &knownTitles) -> ContentProviderResult {
         QHelpCollectionHandler collectionHandler(collectionFile);
         if (!collectionHandler.openCollectionFile())
             return {};
-        return collectionHandler.contentsForFilter(filter);
+        return collectionHandler.contentsForFilter(filter, knownTitles);
     };
 }
 
 static ContentProvider contentProviderFromAttributes(const QStringList &attributes)
 {
-    return [attributes](const QString &collectionFile) -> ContentProviderResult {
+    return [attributes](const QString &collectionFile,
+                const QHash<int, QString> &knownTitles) -> ContentProviderResult {
         QHelpCollectionHandler collectionHandler(collectionFile);
         if (!collectionHandler.openCollectionFile())
             return {};
-        return collectionHandler.contentsForFilter(attributes);
+        return collectionHandler.contentsForFilter(attributes, knownTitles);
     };
 }
 
@@ -888,7 +987,7 @@ QFuture<ContentResult> QHelpEngineCore::requestContentForCurrentFilter() const
     const ContentProvider provider = usesFilterEngine()
             ? contentProviderFromFilterEngine(filterEngine()->activeFilter())
             : contentProviderFromAttributes(filterAttributes(d->currentFilter));
-    return QtConcurrent::run(requestContentHelper, provider, collectionFile());
+    return QtConcurrent::run(requestContentHelper, provider, collectionFile(), d->contentsCache);
 }
 
 QFuture<ContentResult> QHelpEngineCore::requestContent(const QString &filter) const
@@ -896,7 +995,7 @@ QFuture<ContentResult> QHelpEngineCore::requestContent(const QString &filter) co
     const ContentProvider provider = usesFilterEngine()
             ? contentProviderFromFilterEngine(filter)
             : contentProviderFromAttributes(filterAttributes(filter));
-    return QtConcurrent::run(requestContentHelper, provider, collectionFile());
+    return QtConcurrent::run(requestContentHelper, provider, collectionFile(), d->contentsCache);
 }
 
 using IndexProvider = std::function<QStringList(const QString &)>;
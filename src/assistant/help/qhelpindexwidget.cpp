@@ -31,10 +31,19 @@ public:
 #if QT_CONFIG(future)
     void createIndex(const FutureProvider &futureProvider);
 #endif
+    void setIndices(const QStringList &newIndices);
 
     QHelpIndexModel *q = nullptr;
     QHelpEngineCore *helpEngine = nullptr;
     QStringList indices = {};
+    // Case folded copy of indices, so that filtering can use plain,
+    // case sensitive comparisons.
+    QStringList foldedIndices = {};
+    // Rows of indices matching the last applied filter. When the user
+    // keeps typing, only these need to be checked again.
+    QList<qsizetype> matchingRows = {};
+    QString lastFoldedFilter = {};
+    QString lastWildcard = {};
 #if QT_CONFIG(future)
     std::unique_ptr<QFutureWatcher<QStringList>, WatcherDeleter> watcher = {};
 #endif
@@ -47,7 +56,7 @@ void QHelpIndexModelPrivate::createIndex(const FutureProvider &futureProvider)
     watcher.reset(new QFutureWatcher<QStringList>);
     QObject::connect(watcher.get(), &QFutureWatcherBase::finished, q, [this] {
         if (!watcher->isCanceled()) {
-            indices = watcher->result();
+            setIndices(watcher->result());
             q->filter({});
         }
         watcher.release()->deleteLater();
@@ -58,12 +67,24 @@ void QHelpIndexModelPrivate::createIndex(const FutureProvider &futureProvider)
     if (wasRunning)
         return;
 
-    indices.clear();
+    setIndices({});
     q->filter({});
     emit q->indexCreationStarted();
 }
 #endif
 
+void QHelpIndexModelPrivate::setIndices(const QStringList &newIndices)
+{
+    indices = newIndices;
+    foldedIndices.clear();
+    foldedIndices.reserve(indices.size());
+    for (const QString &index : std::as_const(indices))
+        foldedIndices.append(index.toCaseFolded());
+    matchingRows.clear();
+    lastFoldedFilter.clear();
+    lastWildcard.clear();
+}
+
 /*!
     \class QHelpIndexModel
     \since 4.4
@@ -161,45 +182,81 @@ QHelpEngineCore *QHelpIndexModel::helpEngine() const
 QModelIndex QHelpIndexModel::filter(const QString &filter, const QString &wildcard)
 {
     if (filter.isEmpty()) {
+        d->matchingRows.clear();
+        d->lastFoldedFilter.clear();
+        d->lastWildcard.clear();
         setStringList(d->indices);
         return index(-1, 0, {});
     }
 
-    using Checker = std::function<bool(const QString &)>;
-    const auto checkIndices = [this, filter](const Checker &checker) {
-        QStringList filteredList;
+    const QString foldedFilter = filter.toCaseFolded();
+
+    // While the user keeps typing, every keyword matching the longer filter
+    // also matched the previous one, so only the previous matches need to be
+    // checked again. The same holds when only the filter changes while the
+    // wildcard stays the same, because then the filter only selects the
+    // best match.
+    const bool narrowing = !d->lastFoldedFilter.isEmpty() && wildcard == d->lastWildcard
+            && (!wildcard.isEmpty() || foldedFilter.contains(d->lastFoldedFilter));
+    const bool sameRows = narrowing && !wildcard.isEmpty();
+
+    using Checker = std::function<bool(qsizetype)>;
+    const auto checkIndices = [this, &filter, &foldedFilter, narrowing](const Checker &checker) {
+        QList<qsizetype> rows;
+        if (narrowing) {
+            for (qsizetype row : std::as_const(d->matchingRows)) {
+                if (checker(row))
+                    rows.append(row);
+            }
+        } else {
+            for (qsizetype row = 0; row < d->indices.size(); ++row) {
+                if (checker(row))
+                    rows.append(row);
+            }
+        }
+
         int goodMatch = -1;
         int perfectMatch = -1;
-        for (const QString &index : std::as_const(d->indices)) {
-            if (checker(index)) {
-                filteredList.append(index);
-                if (perfectMatch == -1 && index.startsWith(filter, Qt::CaseInsensitive)) {
-                    if (goodMatch == -1)
-                        goodMatch = filteredList.size() - 1;
-                    if (filter.size() == index.size())
-                        perfectMatch = filteredList.size() - 1;
-                } else if (perfectMatch > -1 && index == filter) {
-                    perfectMatch = filteredList.size() - 1;
-                }
+        for (int i = 0; i < rows.size(); ++i) {
+            const QString &index = d->indices.at(rows.at(i));
+            if (perfectMatch == -1 && d->foldedIndices.at(rows.at(i)).startsWith(foldedFilter)) {
+                if (goodMatch == -1)
+                    goodMatch = i;
+                if (filter.size() == index.size())
+                    perfectMatch = i;
+            } else if (perfectMatch > -1 && index == filter) {
+                perfectMatch = i;
             }
         }
-        setStringList(filteredList);
+
+        if (rows != d->matchingRows || rowCount() != rows.size()) {
+            QStringList filteredList;
+            filteredList.reserve(rows.size());
+            for (qsizetype row : std::as_const(rows))
+                filteredList.append(d->indices.at(row));
+            setStringList(filteredList);
+            d->matchingRows = std::move(rows);
+        }
         return perfectMatch >= 0 ? perfectMatch : qMax(0, goodMatch);
     };
 
     int perfectMatch = -1;
-    if (!wildcard.isEmpty()) {
+    if (sameRows) {
+        perfectMatch = checkIndices([](qsizetype) { return true; });
+    } else if (!wildcard.isEmpty()) {
         const auto re = QRegularExpression::wildcardToRegularExpression(wildcard,
                         QRegularExpression::UnanchoredWildcardConversion);
         const QRegularExpression regExp(re, QRegularExpression::CaseInsensitiveOption);
-        perfectMatch = checkIndices([regExp](const QString &index) {
-            return index.contains(regExp);
+        perfectMatch = checkIndices([this, regExp](qsizetype row) {
+            return d->indices.at(row).contains(regExp);
         });
     } else {
-        perfectMatch = checkIndices([filter](const QString &index) {
-            return index.contains(filter, Qt::CaseInsensitive);
+        perfectMatch = checkIndices([this, &foldedFilter](qsizetype row) {
+            return d->foldedIndices.at(row).contains(foldedFilter);
         });
     }
+    d->lastFoldedFilter = foldedFilter;
+    d->lastWildcard = wildcard;
     return index(perfectMatch, 0, {});
 }
 
@@ -18,8 +18,18 @@
 #include <QtCore/QDateTime>
 #include <QtCore/QStringConverter>
 #include <QtCore/QDataStream>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QFuture>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QPromise>
+#include <QtCore/QQueue>
+#include <QtCore/QThreadPool>
+#include <QtSql/QSqlDatabase>
 #include <QtSql/QSqlQuery>
 
+#include <memory>
+
 #include <stdio.h>
 
 QT_BEGIN_NAMESPACE
@@ -49,6 +59,23 @@ private:
         QString title;
     };
 
+    struct FileData
+    {
+        QString name;
+        QString filePath;
+        QString title;
+        QByteArray contentHash;
+        QByteArray data;
+        bool compressed = false;
+        bool isNew = false;
+        bool exists = false;
+        bool opened = false;
+    };
+
+    void readFileData(FileData *fileData);
+    QFuture<FileData> startReadFileData(FileData fileData);
+    int insertFileBlob(const QByteArray &contentHash, const QByteArray &compressedData);
+
     void writeTree(QDataStream &s, QHelpDataContentItem *item, int depth);
     bool createTables();
     bool insertFileNotFoundFile();
@@ -75,6 +102,10 @@ private:
 
     QMap<QString, int> m_fileMap;
     QMap<int, QSet<int> > m_fileFilterMap;
+    QHash<QByteArray, int> m_blobMap;
+
+    QMutex m_claimedHashesMutex;
+    QSet<QByteArray> m_claimedHashes;
 
     double m_progress;
     double m_oldProgress;
@@ -130,8 +161,15 @@ bool HelpGeneratorPrivate::generate(QHelpProjectData *helpData,
         return false;
     }
 
+    // The output file is created from scratch and is useless if generation
+    // fails, so trade durability for speed. The page size has to be set
+    // before the first table gets created.
+    m_query->exec(QLatin1String("PRAGMA page_size=8192"));
     m_query->exec(QLatin1String("PRAGMA synchronous=OFF"));
-    m_query->exec(QLatin1String("PRAGMA cache_size=3000"));
+    m_query->exec(QLatin1String("PRAGMA journal_mode=MEMORY"));
+    m_query->exec(QLatin1String("PRAGMA locking_mode=EXCLUSIVE"));
+    m_query->exec(QLatin1String("PRAGMA temp_store=MEMORY"));
+    m_query->exec(QLatin1String("PRAGMA cache_size=-32768"));
 
     addProgress(1.0);
     createTables();
@@ -280,9 +318,19 @@ bool HelpGeneratorPrivate::createTables()
             << QLatin1String("CREATE TABLE FileAttributeSetTable ("
                              "Id INTEGER, "
                              "FilterAttributeId INTEGER )")
-            << QLatin1String("CREATE TABLE FileDataTable ("
+            << QLatin1String("CREATE TABLE FileBlobTable ("
                              "Id INTEGER PRIMARY KEY, "
                              "Data BLOB )")
+            << QLatin1String("CREATE TABLE FileBlobMapTable ("
+                             "FileId INTEGER PRIMARY KEY, "
+                             "BlobId INTEGER )")
+            // Files with identical contents share one blob. Readers keep
+            // looking up the data by file id through this view.
+            << QLatin1String("CREATE VIEW FileDataTable AS SELECT "
+                             "FileBlobMapTable.FileId AS Id, "
+                             "FileBlobTable.Data AS Data "
+                             "FROM FileBlobMapTable, FileBlobTable "
+                             "WHERE FileBlobMapTable.BlobId = FileBlobTable.Id")
             << QLatin1String("CREATE TABLE FileFilterTable ("
                              "FilterAttributeId INTEGER, "
                              "FileId INTEGER )")
@@ -320,11 +368,18 @@ bool HelpGeneratorPrivate::insertFileNotFoundFile()
     if (m_query->next() && m_query->isValid())
         return true;
 
-    m_query->prepare(QLatin1String("INSERT INTO FileDataTable VALUES (Null, ?)"));
+    m_query->prepare(QLatin1String("INSERT INTO FileBlobTable VALUES (Null, ?)"));
     m_query->bindValue(0, QByteArray());
     if (!m_query->exec())
         return false;
 
+    // prepare() resets lastInsertId(), so fetch the blob id before.
+    const QVariant blobId = m_query->lastInsertId();
+    m_query->prepare(QLatin1String("INSERT INTO FileBlobMapTable VALUES (Null, ?)"));
+    m_query->bindValue(0, blobId);
+    if (!m_query->exec())
+        return false;
+
     const int fileId = m_query->lastInsertId().toInt();
     m_query->prepare(QLatin1String("INSERT INTO FileNameTable (FolderId, Name, FileId, Title) "
         " VALUES (0, '', ?, '')"));
@@ -387,6 +442,83 @@ bool HelpGeneratorPrivate::registerVirtualFolder(const QString &folderName, cons
     return false;
 }
 
+/*!
+    Reads the file described by \a fileData and, if it is a file not yet
+    stored in the database, extracts its title and hashes its contents.
+    The contents are compressed only if no other file with the same
+    contents has been claimed for compression yet.
+    This is called from the worker threads, so apart from the claimed
+    hashes it must not touch any member.
+*/
+void HelpGeneratorPrivate::readFileData(FileData *fileData)
+{
+    QFile fi(fileData->filePath);
+    fileData->exists = fi.exists();
+    if (!fileData->exists)
+        return;
+
+    fileData->opened = fi.open(QIODevice::ReadOnly);
+    if (!fileData->opened || !fileData->isNew)
+        return;
+
+    QByteArray data = fi.readAll();
+    const QString &fileName = fileData->name;
+    if (fileName.endsWith(QLatin1String(".html"))
+        || fileName.endsWith(QLatin1String(".htm"))) {
+        auto encoding = QStringDecoder::encodingForHtml(data);
+        if (!encoding)
+            encoding = QStringDecoder::Utf8;
+        fileData->title = QHelpGlobal::documentTitle(QStringDecoder(*encoding)(data));
+    } else {
+        fileData->title = fileName.mid(fileName.lastIndexOf(QLatin1Char('/')) + 1);
+    }
+
+    fileData->contentHash = QCryptographicHash::hash(data, QCryptographicHash::Sha256);
+    bool claimed = false;
+    {
+        QMutexLocker locker(&m_claimedHashesMutex);
+        claimed = m_claimedHashes.contains(fileData->contentHash);
+        if (!claimed)
+            m_claimedHashes.insert(fileData->contentHash);
+    }
+    fileData->compressed = !claimed;
+    fileData->data = claimed ? std::move(data) : qCompress(data);
+}
+
+QFuture<HelpGeneratorPrivate::FileData> HelpGeneratorPrivate::startReadFileData(FileData fileData)
+{
+    auto promise = std::make_shared<QPromise<FileData>>();
+    QFuture<FileData> future = promise->future();
+    promise->start();
+    QThreadPool::globalInstance()->start([this, promise, fileData = std::move(fileData)]() mutable {
+        readFileData(&fileData);
+        promise->addResult(std::move(fileData));
+        promise->finish();
+    });
+    return future;
+}
+
+/*!
+    Returns the id of the blob holding the data with \a contentHash.
+    If there is none yet, \a compressedData is stored as a new blob.
+*/
+int HelpGeneratorPrivate::insertFileBlob(const QByteArray &contentHash,
+                                         const QByteArray &compressedData)
+{
+    const auto it = m_blobMap.constFind(contentHash);
+    if (it != m_blobMap.cend())
+        return it.value();
+
+    m_query->prepare(QLatin1String("INSERT INTO FileBlobTable VALUES (Null, ?)"));
+    m_query->bindValue(0, compressedData);
+    if (!m_query->exec())
+        return -1;
+
+    const int blobId = m_query->lastInsertId().toInt();
+    m_blobMap.insert(contentHash, blobId);
+    return blobId;
+}
+
 bool HelpGeneratorPrivate::insertFiles(const QStringList &files, const QString &rootPath,
                                  const QStringList &filterAttributes)
 {
@@ -426,58 +558,87 @@ bool HelpGeneratorPrivate::insertFiles(const QStringList &files, const QString &
     if (m_query->next())
         tableFileId = m_query->value(0).toInt() + 1;
 
-    QString title;
-    QString charSet;
-    QList<QByteArray> fileDataList;
     QMap<int, QSet<int> > tmpFileFilterMap;
     QList<FileNameTableData> fileNameDataList;
 
+    // Reading and compressing is done by the thread pool, while the results
+    // are consumed here in the original order, so the file ids are identical
+    // to a sequential run. The number of files in flight is bounded, so only
+    // a small window of the compressed data is kept in memory at a time.
+    const qsizetype maxPendingFiles = qMax(QThreadPool::globalInstance()->maxThreadCount(), 1) * 4;
+    QQueue<QFuture<FileData>> pendingFiles;
+    QSet<QString> queuedNames;
+    auto nextFile = files.cbegin();
+    const auto filesEnd = files.cend();
+
+    // insertFileBlob() uses m_query, so the mapping needs its own query
+    // to be prepared only once.
+    QSqlQuery blobMapQuery(QSqlDatabase::database(QLatin1String("builder")));
+    blobMapQuery.prepare(QLatin1String("INSERT INTO FileBlobMapTable VALUES (?, ?)"));
+
     int i = 0;
-    for (const QString &file : files) {
-        const QString fileName = QDir::cleanPath(file);
+    bool inTransaction = false;
+    while (nextFile != filesEnd || !pendingFiles.isEmpty()) {
+        while (nextFile != filesEnd && pendingFiles.size() < maxPendingFiles) {
+            FileData fileData;
+            fileData.name = QDir::cleanPath(*nextFile++);
+            fileData.filePath = rootPath + QDir::separator() + fileData.name;
+            fileData.isNew = !m_fileMap.contains(fileData.name)
+                    && !queuedNames.contains(fileData.name);
+            if (fileData.isNew)
+                queuedNames.insert(fileData.name);
+            pendingFiles.enqueue(startReadFileData(std::move(fileData)));
+        }
 
-        QFile fi(rootPath + QDir::separator() + fileName);
-        if (!fi.exists()) {
+        FileData fileData = pendingFiles.dequeue().result();
+        if (!fileData.exists) {
             emit warning(tr("The file %1 does not exist, skipping it...")
-                .arg(QDir::cleanPath(rootPath + QDir::separator() + fileName)));
+                .arg(QDir::cleanPath(fileData.filePath)));
             continue;
         }
 
-        if (!fi.open(QIODevice::ReadOnly)) {
+        if (!fileData.opened) {
             emit warning(tr("Cannot open file %1, skipping it...")
-                .arg(QDir::cleanPath(rootPath + QDir::separator() + fileName)));
+                .arg(QDir::cleanPath(fileData.filePath)));
             continue;
         }
 
-        QByteArray data = fi.readAll();
-        if (fileName.endsWith(QLatin1String(".html"))
-            || fileName.endsWith(QLatin1String(".htm"))) {
-            auto encoding = QStringDecoder::encodingForHtml(data);
-            if (!encoding)
-                encoding = QStringDecoder::Utf8;
-            title = QHelpGlobal::documentTitle(QStringDecoder(*encoding)(data));
-        } else {
-            title = fileName.mid(fileName.lastIndexOf(QLatin1Char('/')) + 1);
-        }
-
-        int fileId = -1;
-        const auto &it = m_fileMap.constFind(fileName);
+        const auto &it = m_fileMap.constFind(fileData.name);
         if (it == m_fileMap.cend()) {
-            fileDataList.append(qCompress(data));
+            if (!fileData.isNew) {
+                // An earlier occurrence of this name could not be read.
+                fileData.isNew = true;
+                readFileData(&fileData);
+            }
+            if (!inTransaction) {
+                m_query->exec(QLatin1String("BEGIN"));
+                inTransaction = true;
+            }
+
+            // The worker claiming these contents may come later in the
+            // queue, so compress them here if nothing was stored yet.
+            if (!fileData.compressed && !m_blobMap.contains(fileData.contentHash))
+                fileData.data = qCompress(fileData.data);
+            const int blobId = insertFileBlob(fileData.contentHash, fileData.data);
+            blobMapQuery.bindValue(0, tableFileId);
+            blobMapQuery.bindValue(1, blobId);
+            blobMapQuery.exec();
+            if (++i % 20 == 0)
+                addProgress(m_fileStep * 20.0);
 
             FileNameTableData fileNameData;
-            fileNameData.name = fileName;
+            fileNameData.name = fileData.name;
             fileNameData.fileId = tableFileId;
-            fileNameData.title = title;
+            fileNameData.title = fileData.title;
             fileNameDataList.append(fileNameData);
 
-            m_fileMap.insert(fileName, tableFileId);
+            m_fileMap.insert(fileData.name, tableFileId);
             m_fileFilterMap.insert(tableFileId, filterAtts);
             tmpFileFilterMap.insert(tableFileId, filterAtts);
 
             ++tableFileId;
         } else {
-            fileId = it.value();
+            const int fileId = it.value();
             QSet<int> &fileFilterSet = m_fileFilterMap[fileId];
             QSet<int> &tmpFileFilterSet = tmpFileFilterMap[fileId];
             for (int filter : std::as_const(filterAtts)) {
@@ -491,31 +652,23 @@ bool HelpGeneratorPrivate::insertFiles(const QStringList &files, const QString &
     }
 
     if (!tmpFileFilterMap.isEmpty()) {
-        m_query->exec(QLatin1String("BEGIN"));
+        if (!inTransaction)
+            m_query->exec(QLatin1String("BEGIN"));
+        m_query->prepare(QLatin1String("INSERT INTO FileFilterTable "
+            "VALUES(?, ?)"));
         for (auto it = tmpFileFilterMap.cbegin(), end = tmpFileFilterMap.cend(); it != end; ++it) {
             QList<int> filterValues = it.value().values();
             std::sort(filterValues.begin(), filterValues.end());
             for (int fv : std::as_const(filterValues)) {
-                m_query->prepare(QLatin1String("INSERT INTO FileFilterTable "
-                    "VALUES(?, ?)"));
                 m_query->bindValue(0, fv);
                 m_query->bindValue(1, it.key());
                 m_query->exec();
             }
         }
 
-        for (const QByteArray &fileData : std::as_const(fileDataList)) {
-            m_query->prepare(QLatin1String("INSERT INTO FileDataTable VALUES "
-                "(Null, ?)"));
-            m_query->bindValue(0, fileData);
-            m_query->exec();
-            if (++i % 20 == 0)
-                addProgress(m_fileStep * 20.0);
-        }
-
+        m_query->prepare(QLatin1String("INSERT INTO FileNameTable "
+            "(FolderId, Name, FileId, Title) VALUES (?, ?, ?, ?)"));
         for (const FileNameTableData &fnd : std::as_const(fileNameDataList)) {
-            m_query->prepare(QLatin1String("INSERT INTO FileNameTable "
-                "(FolderId, Name, FileId, Title) VALUES (?, ?, ?, ?)"));
             m_query->bindValue(0, 1);
             m_query->bindValue(1, fnd.name);
             m_query->bindValue(2, fnd.fileId);
@@ -106,8 +106,10 @@ namespace litehtml
 		void							dump(dumper& cout);
 
 		static litehtml::document::ptr	createFromString(const char* str, litehtml::document_container* objPainter, const char* master_styles = litehtml::master_css, const char* user_styles = "");
+		static litehtml::document::ptr	createFromString(const char* str, litehtml::document_container* objPainter, const litehtml::css& master_styles, const litehtml::css& user_styles);
 	
 	private:
+		void	init_from_string(const char* str);
 		uint_ptr	add_font(const char* name, int size, const char* weight, const char* style, const char* decoration, font_metrics* fm);
 
 		void create_node(void* gnode, elements_list& elements, bool parseTextNode);
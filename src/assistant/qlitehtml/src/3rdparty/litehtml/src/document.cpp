@@ -49,22 +49,9 @@ litehtml::document::~document()
 
 litehtml::document::ptr litehtml::document::createFromString( const char* str, document_container* objPainter, const char* master_styles, const char* user_styles )
 {
-	// parse document into GumboOutput
-	GumboOutput* output = gumbo_parse(str);
-
 	// Create litehtml::document
 	document::ptr doc = std::make_shared<document>(objPainter);
 
-	// Create litehtml::elements.
-	elements_list root_elements;
-	doc->create_node(output->root, root_elements, true);
-	if (!root_elements.empty())
-	{
-		doc->m_root = root_elements.back();
-	}
-	// Destroy GumboOutput
-	gumbo_destroy_output(&kGumboDefaultOptions, output);
-
 	if (master_styles && *master_styles)
 	{
 		doc->m_master_css.parse_stylesheet(master_styles, nullptr, doc, nullptr);
@@ -76,6 +63,38 @@ litehtml::document::ptr litehtml::document::createFromString( const char* str, d
 		doc->m_user_css.sort_selectors();
 	}
 
+	doc->init_from_string(str);
+	return doc;
+}
+
+litehtml::document::ptr litehtml::document::createFromString( const char* str, document_container* objPainter, const css& master_styles, const css& user_styles )
+{
+	// Create litehtml::document with already parsed and sorted style sheets
+	document::ptr doc = std::make_shared<document>(objPainter);
+	doc->m_master_css = master_styles;
+	doc->m_user_css = user_styles;
+
+	doc->init_from_string(str);
+	return doc;
+}
+
+void litehtml::document::init_from_string( const char* str )
+{
+	document::ptr doc = shared_from_this();
+
+	// parse document into GumboOutput
+	GumboOutput* output = gumbo_parse(str);
+
+	// Create litehtml::elements.
+	elements_list root_elements;
+	doc->create_node(output->root, root_elements, true);
+	if (!root_elements.empty())
+	{
+		doc->m_root = root_elements.back();
+	}
+	// Destroy GumboOutput
+	gumbo_destroy_output(&kGumboDefaultOptions, output);
+
 	// Let's process created elements tree
 	if (doc->m_root)
 	{
@@ -133,8 +152,6 @@ litehtml::document::ptr litehtml::document::createFromString( const char* str, d
 		// init() return pointer to the render_init element because it can change its type
 		doc->m_root_render = doc->m_root_render->init();
 	}
-
-	return doc;
 }
 
 litehtml::uint_ptr litehtml::document::add_font( const char* name, int size, const char* weight, const char* style, const char* decoration, font_metrics* fm )
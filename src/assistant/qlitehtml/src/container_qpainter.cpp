@@ -4,6 +4,7 @@
 #include "container_qpainter.h"
 #include "container_qpainter_p.h"
 
+#include <QBuffer>
 #if QT_CONFIG(clipboard)
 #include <QClipboard>
 #endif
@@ -14,28 +15,42 @@
 #include <QFontDatabase>
 #include <QFontMetrics>
 #include <QGuiApplication>
+#include <QImageReader>
 #include <QLoggingCategory>
 #include <QPainter>
 #include <QPalette>
 #include <QRegularExpression>
 #include <QScreen>
 #include <QTextLayout>
+#include <QThreadPool>
 #include <QUrl>
 
 #include <algorithm>
 
 const int kDragDistance = 5;
 
-using Font = QFont;
 using Context = QPainter;
 
+// text fragments measured per font before the width cache is reset
+const int kMaxCachedTextWidths = 8192;
+
+// maximum size of the decoded images that are kept for reuse, in KiB
+const int kMaxCachedImagesSize = 64 * 1024;
+
 namespace {
 static Q_LOGGING_CATEGORY(log, "qlitehtml", QtCriticalMsg)
 }
 
-static QFont toQFont(litehtml::uint_ptr hFont)
+Q_GLOBAL_STATIC(ImageCache, imageCache)
+
+static Font *toFont(litehtml::uint_ptr hFont)
 {
-    return *reinterpret_cast<Font *>(hFont);
+    return reinterpret_cast<Font *>(hFont);
+}
+
+static const QFont &toQFont(litehtml::uint_ptr hFont)
+{
+    return toFont(hFont)->font;
 }
 
 static QPainter *toQPainter(litehtml::uint_ptr hdc)
@@ -169,8 +184,7 @@ static Selection::Element selectionDetails(const litehtml::element::ptr &element
     // shortcut, which _might_ not really be correct
     if (!element->children().empty())
         return {element, -1, -1}; // everything selected
-    const QFont &font = toQFont(element->css().get_font());
-    const QFontMetrics fm(font);
+    const QFontMetrics &fm = toFont(element->css().get_font())->metrics;
     int previous = 0;
     for (int i = 0; i < text.size(); ++i) {
         const int width = fm.size(0, text.left(i + 1)).width();
@@ -447,12 +461,106 @@ QRect Selection::boundingRect() const
     return rect;
 }
 
+ImageCache::ImageCache()
+    : m_images(kMaxCachedImagesSize)
+{}
+
+ImageCache *ImageCache::instance()
+{
+    return imageCache();
+}
+
+void ImageCache::addDocument(DocumentContainerPrivate *document)
+{
+    m_documents.append(document);
+}
+
+void ImageCache::removeDocument(DocumentContainerPrivate *document)
+{
+    m_documents.removeOne(document);
+}
+
+const QImage *ImageCache::image(const QUrl &url) const
+{
+    return m_images.object(url);
+}
+
+QSize ImageCache::size(const QUrl &url) const
+{
+    if (const QImage *image = m_images.object(url))
+        return image->size();
+    return m_loading.value(url);
+}
+
+void ImageCache::load(const QUrl &url, const DocumentContainer::DataCallback &dataCallback)
+{
+    if (m_loading.contains(url))
+        return;
+    const QByteArray data = dataCallback(url);
+    QBuffer buffer;
+    buffer.setData(data);
+    QImageReader reader(&buffer);
+    const QSize size = reader.size();
+    if (!size.isValid()) {
+        // the size is needed for layouting, so decode right away if the header does not tell
+        finishLoading(url, reader.read());
+        return;
+    }
+    m_loading.insert(url, size);
+    QThreadPool::globalInstance()->start([url, data] {
+        QImage image;
+        image.loadFromData(data);
+        QMetaObject::invokeMethod(
+            QCoreApplication::instance(),
+            [url, image] { ImageCache::instance()->finishLoading(url, image); },
+            Qt::QueuedConnection);
+    });
+}
+
+void ImageCache::finishLoading(const QUrl &url, const QImage &image)
+{
+    m_loading.remove(url);
+    if (!image.isNull())
+        m_images.insert(url, new QImage(image), std::max(1, int(image.sizeInBytes() / 1024)));
+    for (DocumentContainerPrivate *document : std::as_const(m_documents))
+        document->imageLoaded(url, image);
+}
+
+DocumentContainerPrivate::DocumentContainerPrivate()
+{
+    ImageCache::instance()->addDocument(this);
+}
+
+DocumentContainerPrivate::~DocumentContainerPrivate()
+{
+    if (ImageCache *cache = ImageCache::instance())
+        cache->removeDocument(this);
+}
+
 DocumentContainer::DocumentContainer()
     : d(new DocumentContainerPrivate)
 {}
 
 DocumentContainer::~DocumentContainer() = default;
 
+int Font::textWidth(const char *text)
+{
+    const auto length = qsizetype(std::strlen(text));
+    const QByteArray key = QByteArray::fromRawData(text, length);
+    const auto it = widths.constFind(key);
+    if (it != widths.cend())
+        return it.value();
+
+    // most text in documentation is ASCII, which does not need UTF-8 decoding
+    const bool isAscii = std::all_of(text, text + length, [](char c) { return uchar(c) < 0x80; });
+    const int width = metrics.horizontalAdvance(isAscii ? QString::fromLatin1(text, length)
+                                                        : QString::fromUtf8(text, length));
+    if (widths.size() >= kMaxCachedTextWidths)
+        widths.clear();
+    widths.insert(QByteArray(text, length), width);
+    return width;
+}
+
 litehtml::uint_ptr DocumentContainerPrivate::create_font(const char *faceName,
                                                          int size,
                                                          int weight,
@@ -460,60 +568,64 @@ litehtml::uint_ptr DocumentContainerPrivate::create_font(const char *faceName,
                                                          unsigned int decoration,
                                                          litehtml::font_metrics *fm)
 {
-    const QStringList splitNames = QString::fromUtf8(faceName).split(',', Qt::SkipEmptyParts);
-    QStringList familyNames;
-    std::transform(splitNames.cbegin(),
-                   splitNames.cend(),
-                   std::back_inserter(familyNames),
-                   [this](const QString &s) {
-                       // clean whitespace and quotes
-                       QString name = s.trimmed();
-                       if (name.startsWith('\"'))
-                           name = name.mid(1);
-                       if (name.endsWith('\"'))
-                           name.chop(1);
-                       const QString lowerName = name.toLower();
-                       if (lowerName == "serif")
-                           return serifFont();
-                       if (lowerName == "sans-serif")
-                           return sansSerifFont();
-                       if (lowerName == "monospace")
-                           return monospaceFont();
-                       return name;
-                   });
-    auto font = new QFont();
-    font->setFamilies(familyNames);
-    font->setPixelSize(size);
-    font->setWeight(cssWeightToQtWeight(weight));
-    font->setStyle(toQFontStyle(italic));
-    font->setStyleStrategy(m_antialias ? QFont::PreferAntialias : QFont::NoAntialias);
-    if (decoration == litehtml::font_decoration_underline)
-        font->setUnderline(true);
-    if (decoration == litehtml::font_decoration_overline)
-        font->setOverline(true);
-    if (decoration == litehtml::font_decoration_linethrough)
-        font->setStrikeOut(true);
+    FontKey key{faceName, size, weight, int(italic), decoration, m_antialias};
+    std::unique_ptr<Font> &cached = m_fonts[std::move(key)];
+    if (!cached) {
+        const QStringList splitNames = QString::fromUtf8(faceName).split(',', Qt::SkipEmptyParts);
+        QStringList familyNames;
+        std::transform(splitNames.cbegin(),
+                       splitNames.cend(),
+                       std::back_inserter(familyNames),
+                       [this](const QString &s) {
+                           // clean whitespace and quotes
+                           QString name = s.trimmed();
+                           if (name.startsWith('\"'))
+                               name = name.mid(1);
+                           if (name.endsWith('\"'))
+                               name.chop(1);
+                           const QString lowerName = name.toLower();
+                           if (lowerName == "serif")
+                               return serifFont();
+                           if (lowerName == "sans-serif")
+                               return sansSerifFont();
+                           if (lowerName == "monospace")
+                               return monospaceFont();
+                           return name;
+                       });
+        QFont font;
+        font.setFamilies(familyNames);
+        font.setPixelSize(size);
+        font.setWeight(cssWeightToQtWeight(weight));
+        font.setStyle(toQFontStyle(italic));
+        font.setStyleStrategy(m_antialias ? QFont::PreferAntialias : QFont::NoAntialias);
+        if (decoration == litehtml::font_decoration_underline)
+            font.setUnderline(true);
+        if (decoration == litehtml::font_decoration_overline)
+            font.setOverline(true);
+        if (decoration == litehtml::font_decoration_linethrough)
+            font.setStrikeOut(true);
+        cached = std::make_unique<Font>(font);
+    }
     if (fm) {
-        const QFontMetrics metrics(*font);
+        const QFontMetrics &metrics = cached->metrics;
         fm->height = metrics.height();
         fm->ascent = metrics.ascent();
         fm->descent = metrics.descent();
         fm->x_height = metrics.xHeight();
         fm->draw_spaces = true;
     }
-    return reinterpret_cast<litehtml::uint_ptr>(font);
+    return reinterpret_cast<litehtml::uint_ptr>(cached.get());
 }
 
 void DocumentContainerPrivate::delete_font(litehtml::uint_ptr hFont)
 {
-    auto font = reinterpret_cast<Font *>(hFont);
-    delete font;
+    // fonts are owned by m_fonts and reused by the following documents
+    Q_UNUSED(hFont)
 }
 
 int DocumentContainerPrivate::text_width(const char *text, litehtml::uint_ptr hFont)
 {
-    const QFontMetrics fm(toQFont(hFont));
-    return fm.horizontalAdvance(QString::fromUtf8(text));
+    return toFont(hFont)->textWidth(text);
 }
 
 void DocumentContainerPrivate::draw_text(litehtml::uint_ptr hdc,
@@ -584,12 +696,16 @@ void DocumentContainerPrivate::load_image(const char *src, const char *baseurl,
     qDebug(log) << "load_image:" << QString("src = \"%1\";").arg(qtSrc).toUtf8().constData()
                 << QString("base = \"%1\"").arg(qtBaseUrl).toUtf8().constData();
     const QUrl url = resolveUrl(qtSrc, qtBaseUrl);
-    if (m_pixmaps.contains(url))
+    if (m_pixmaps.contains(url) || m_pendingImages.contains(url))
         return;
 
-    QPixmap pixmap;
-    pixmap.loadFromData(m_dataCallback(url));
-    m_pixmaps.insert(url, pixmap);
+    ImageCache *cache = ImageCache::instance();
+    if (const QImage *image = cache->image(url)) {
+        m_pixmaps.insert(url, QPixmap::fromImage(*image));
+        return;
+    }
+    m_pendingImages.insert(url);
+    cache->load(url, m_dataCallback);
 }
 
 void DocumentContainerPrivate::get_image_size(const char *src,
@@ -602,9 +718,12 @@ void DocumentContainerPrivate::get_image_size(const char *src,
         return;
     qDebug(log) << "get_image_size:" << QString("src = \"%1\";").arg(qtSrc).toUtf8().constData()
                 << QString("base = \"%1\"").arg(qtBaseUrl).toUtf8().constData();
-    const QPixmap pm = getPixmap(qtSrc, qtBaseUrl);
-    sz.width = pm.width();
-    sz.height = pm.height();
+    // images that are still decoded report the size from their header
+    const QUrl url = resolveUrl(qtSrc, qtBaseUrl);
+    const auto it = m_pixmaps.constFind(url);
+    const QSize size = it != m_pixmaps.constEnd() ? it->size() : ImageCache::instance()->size(url);
+    sz.width = size.width();
+    sz.height = size.height();
 }
 
 void DocumentContainerPrivate::drawSelection(QPainter *painter, const QRect &clip) const
@@ -944,10 +1063,17 @@ void DocumentContainer::setScrollPosition(const QPoint &pos)
 void DocumentContainer::setDocument(const QByteArray &data, DocumentContainerContext *context)
 {
     d->m_pixmaps.clear();
+    d->m_pendingImages.clear();
     d->clearSelection();
-    d->m_document = litehtml::document::createFromString(data.constData(),
-                                                         d.get(),
-                                                         context->d->masterCss.toUtf8().constData());
+    if (context->d->masterStyleSheetShared) {
+        d->m_document = litehtml::document::createFromString(data.constData(),
+                                                             d.get(),
+                                                             context->d->masterStyleSheet,
+                                                             litehtml::css());
+    } else {
+        d->m_document = litehtml::document::createFromString(
+            data.constData(), d.get(), context->d->masterStyleSheetText.constData());
+    }
     d->buildIndex();
 }
 
@@ -1215,8 +1341,7 @@ void DocumentContainer::findText(const QString &text,
         const auto fontPtr = e.element->css().get_font();
         if (!fontPtr)
             return e;
-        const QFont &font = toQFont(fontPtr);
-        const QFontMetrics fm(font);
+        const QFontMetrics &fm = toFont(fontPtr)->metrics;
         return Selection::Element{e.element, e.index, fm.size(0, text.left(e.index)).width()};
     };
 
@@ -1311,6 +1436,11 @@ void DocumentContainer::setClipboardCallback(const DocumentContainer::ClipboardC
     d->m_clipboardCallback = callback;
 }
 
+void DocumentContainer::setRedrawCallback(const DocumentContainer::RedrawCallback &callback)
+{
+    d->m_redrawCallback = callback;
+}
+
 static litehtml::element::ptr elementForY(int y, const litehtml::element::ptr &element)
 {
     if (!element)
@@ -1346,12 +1476,22 @@ QPixmap DocumentContainerPrivate::getPixmap(const QString &imageUrl, const QStri
 {
     const QUrl url = resolveUrl(imageUrl, baseUrl);
     if (!m_pixmaps.contains(url)) {
-        qWarning(log) << "draw_background: pixmap not loaded for" << url;
+        if (!m_pendingImages.contains(url))
+            qWarning(log) << "draw_background: pixmap not loaded for" << url;
         return {};
     }
     return m_pixmaps.value(url);
 }
 
+void DocumentContainerPrivate::imageLoaded(const QUrl &url, const QImage &image)
+{
+    if (!m_pendingImages.remove(url))
+        return;
+    m_pixmaps.insert(url, QPixmap::fromImage(image));
+    if (m_redrawCallback)
+        m_redrawCallback();
+}
+
 QString DocumentContainerPrivate::serifFont() const
 {
     // TODO make configurable
@@ -1418,5 +1558,15 @@ DocumentContainerContext::~DocumentContainerContext() = default;
 
 void DocumentContainerContext::setMasterStyleSheet(const QString &css)
 {
-    d->masterCss = css;
+    d->masterStyleSheetText = css.toUtf8();
+    d->masterStyleSheet.clear();
+    // Parsing needs a document, but only uses it for at-rules. Style sheets with
+    // these are parsed for each document, with its container.
+    d->masterStyleSheetShared = !d->masterStyleSheetText.contains('@');
+    if (!d->masterStyleSheetShared)
+        return;
+    const auto document = std::make_shared<litehtml::document>(nullptr);
+    d->masterStyleSheet.parse_stylesheet(d->masterStyleSheetText.constData(), nullptr,
+                                         document, nullptr);
+    d->masterStyleSheet.sort_selectors();
 }
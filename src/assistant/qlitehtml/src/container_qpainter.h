@@ -100,6 +100,10 @@ public: // outside API
     using ClipboardCallback = std::function<void(bool)>;
     void setClipboardCallback(const ClipboardCallback &callback);
 
+    // called when images finished loading in the background
+    using RedrawCallback = std::function<void()>;
+    void setRedrawCallback(const RedrawCallback &callback);
+
     int withFixedElementPosition(int y, const std::function<void()> &action);
 
 private:
@@ -7,13 +7,22 @@
 
 #include <litehtml.h>
 
+#include <QCache>
+#include <QFont>
+#include <QFontMetrics>
+#include <QHash>
+#include <QImage>
 #include <QPaintDevice>
 #include <QPixmap>
 #include <QPoint>
 #include <QRect>
+#include <QSet>
 #include <QString>
 #include <QVector>
 
+#include <map>
+#include <memory>
+#include <tuple>
 #include <unordered_map>
 
 class Selection
@@ -55,8 +64,80 @@ struct Index
     Entry findElement(int index) const;
 };
 
+// The font handle passed to litehtml. Handles are shared between all
+// documents of a container, so each font combination is resolved once.
+struct Font
+{
+    explicit Font(const QFont &f)
+        : font(f)
+        , metrics(f)
+    {}
+
+    int textWidth(const char *text);
+
+    QFont font;
+    QFontMetrics metrics;
+    // widths of recently measured text fragments, mostly single words
+    QHash<QByteArray, int> widths;
+};
+
+struct FontKey
+{
+    std::string faces;
+    int size = 0;
+    int weight = 0;
+    int style = 0;
+    unsigned int decoration = 0;
+    bool antialias = true;
+
+    bool operator<(const FontKey &other) const
+    {
+        return std::tie(faces, size, weight, style, decoration, antialias)
+               < std::tie(other.faces,
+                          other.size,
+                          other.weight,
+                          other.style,
+                          other.decoration,
+                          other.antialias);
+    }
+};
+
+class DocumentContainerPrivate;
+
+// Decoded images shared by all documents, bounded by the size of the image data.
+// Image sizes are read from the image headers for layouting, the images themselves
+// are decoded in a worker thread, and the waiting documents are notified when done.
+// The data behind an URL is expected not to change, as for qthelp:// URLs, which
+// contain the namespace and version of the documentation.
+class ImageCache
+{
+public:
+    ImageCache();
+
+    static ImageCache *instance();
+
+    void addDocument(DocumentContainerPrivate *document);
+    void removeDocument(DocumentContainerPrivate *document);
+
+    const QImage *image(const QUrl &url) const;
+    QSize size(const QUrl &url) const;
+    void load(const QUrl &url, const DocumentContainer::DataCallback &dataCallback);
+
+private:
+    void finishLoading(const QUrl &url, const QImage &image);
+
+    QCache<QUrl, QImage> m_images;
+    // header sizes of the images that are currently decoded
+    QHash<QUrl, QSize> m_loading;
+    QVector<DocumentContainerPrivate *> m_documents;
+};
+
 class DocumentContainerPrivate final : public litehtml::document_container
 {
+public:
+    DocumentContainerPrivate();
+    ~DocumentContainerPrivate();
+
 public: // document_container API
     litehtml::uint_ptr create_font(const char *faceName,
                                    int size,
@@ -103,6 +184,7 @@ public: // document_container API
     void get_language(std::string &language, std::string &culture) const override;
 
     QPixmap getPixmap(const QString &imageUrl, const QString &baseUrl);
+    void imageLoaded(const QUrl &url, const QImage &image);
     QString serifFont() const;
     QString sansSerifFont() const;
     QString monospaceFont() const;
@@ -123,17 +205,25 @@ public: // document_container API
     QByteArray m_defaultFontFamilyName = m_defaultFont.family().toUtf8();
     bool m_antialias = true;
     QHash<QUrl, QPixmap> m_pixmaps;
+    QSet<QUrl> m_pendingImages;
+    std::map<FontKey, std::unique_ptr<Font>> m_fonts;
     Selection m_selection;
     DocumentContainer::DataCallback m_dataCallback;
     DocumentContainer::CursorCallback m_cursorCallback;
     DocumentContainer::LinkCallback m_linkCallback;
     DocumentContainer::PaletteCallback m_paletteCallback;
     DocumentContainer::ClipboardCallback m_clipboardCallback;
+    DocumentContainer::RedrawCallback m_redrawCallback;
     bool m_blockLinks = false;
 };
 
 class DocumentContainerContextPrivate
 {
 public:
-    QString masterCss;
+    QByteArray masterStyleSheetText;
+    // parsed once and shared by all documents created with this context, unless
+    // the style sheet contains at-rules like @import and @media, which need to
+    // be resolved by the container of each document
+    litehtml::css masterStyleSheet;
+    bool masterStyleSheetShared = false;
 };
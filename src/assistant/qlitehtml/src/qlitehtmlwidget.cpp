@@ -6,12 +6,19 @@
 #include "container_qpainter.h"
 
 #include <QDebug>
+#include <QHash>
 #include <QPaintEvent>
 #include <QPainter>
+#include <QPixmap>
 #include <QScrollBar>
 #include <QStyle>
+#include <QTimer>
 
 const int kScrollBarStep = 40;
+// edge length of the cached tiles, in viewport pixels
+const int kTileSize = 512;
+// delay before the document is laid out again while the widget is being resized
+const int kRelayoutDelay = 50;
 
 // copied from include/litehtml/master_css.h
 const char master_css[] = R"##(
@@ -395,6 +402,11 @@ public:
     DocumentContainer documentContainer;
     qreal zoomFactor = 1;
     QUrl lastHighlightedLink;
+    // rendered tiles of the zoomed document, indexed by column and row
+    QHash<QPoint, QPixmap> tiles;
+    qreal tileDevicePixelRatio = 0;
+    QTimer relayoutTimer;
+    int layoutWidth = 0;
 };
 
 QLiteHtmlWidget::QLiteHtmlWidget(QWidget *parent)
@@ -418,6 +430,16 @@ QLiteHtmlWidget::QLiteHtmlWidget(QWidget *parent)
                  Qt::QueuedConnection);
     });
     d->documentContainer.setClipboardCallback([this](bool yes) { emit copyAvailable(yes); });
+    d->documentContainer.setRedrawCallback([this] {
+        d->tiles.clear();
+        viewport()->update();
+    });
+
+    d->relayoutTimer.setSingleShot(true);
+    d->relayoutTimer.setInterval(kRelayoutDelay);
+    connect(&d->relayoutTimer, &QTimer::timeout, this, [this] {
+        withFixedTextPosition([this] { render(); });
+    });
 
     // TODO adapt mastercss to palette (default text & background color)
     d->context.setMasterStyleSheet(master_css);
@@ -495,18 +517,17 @@ bool QLiteHtmlWidget::findText(const QString &text,
     QRect newSelectionCombined;
     for (const QRect &r : std::as_const(newSelection))
         newSelectionCombined = newSelectionCombined.united(r);
+    // cached tiles need to be updated even if the selection is currently not visible
+    updateDocumentArea(newSelectionCombined);
+    for (const QRect &r : std::as_const(oldSelection))
+        updateDocumentArea(r);
     QScrollBar *vBar = verticalScrollBar();
     const int top = newSelectionCombined.top();
     const int bottom = newSelectionCombined.bottom() - toVirtual(viewport()->size()).height();
-    if (success && top < vBar->value() && vBar->minimum() <= top) {
+    if (success && top < vBar->value() && vBar->minimum() <= top)
         vBar->setValue(top);
-    } else if (success && vBar->value() < bottom && bottom <= vBar->maximum()) {
+    else if (success && vBar->value() < bottom && bottom <= vBar->maximum())
         vBar->setValue(bottom);
-    } else {
-        viewport()->update(fromVirtual(newSelectionCombined.translated(-scrollPosition())));
-        for (const QRect &r : std::as_const(oldSelection))
-            viewport()->update(fromVirtual(r.translated(-scrollPosition())));
-    }
     return success;
 }
 
@@ -560,20 +581,61 @@ void QLiteHtmlWidget::paintEvent(QPaintEvent *event)
 {
     if (!d->documentContainer.hasDocument())
         return;
-    d->documentContainer.setScrollPosition(scrollPosition());
+    const qreal dpr = viewport()->devicePixelRatio();
+    if (dpr != d->tileDevicePixelRatio) {
+        d->tiles.clear();
+        d->tileDevicePixelRatio = dpr;
+    }
+    // tiles are positioned in the coordinates of the zoomed document,
+    // only the tiles that are exposed for the first time need to be drawn by litehtml
+    const QPoint offset = zoomedScrollPosition();
+    const QRect exposed = event->rect().translated(offset);
     QPainter p(viewport());
-    p.setWorldTransform(QTransform().scale(d->zoomFactor, d->zoomFactor));
-    p.setRenderHint(QPainter::SmoothPixmapTransform, true);
-    p.setRenderHint(QPainter::Antialiasing, true);
-    d->documentContainer.draw(&p, toVirtual(event->rect()));
+    for (int row = exposed.top() / kTileSize; row <= exposed.bottom() / kTileSize; ++row) {
+        for (int column = exposed.left() / kTileSize; column <= exposed.right() / kTileSize;
+             ++column) {
+            const QPoint tile(column, row);
+            auto it = d->tiles.constFind(tile);
+            if (it == d->tiles.constEnd())
+                it = d->tiles.insert(tile, renderTile(tile));
+            p.drawPixmap(tileRect(tile).topLeft() - offset, *it);
+        }
+    }
+    // keep the tiles around that are likely to be exposed by scrolling next
+    const QSize size = viewport()->size();
+    const QRect keep = QRect(offset, size).adjusted(-size.width(),
+                                                    -size.height(),
+                                                    size.width(),
+                                                    size.height());
+    d->tiles.removeIf([this, &keep](const auto &it) {
+        return !tileRect(it.key()).intersects(keep);
+    });
 }
 
 void QLiteHtmlWidget::resizeEvent(QResizeEvent *event)
 {
-    withFixedTextPosition([this, event] {
-        QAbstractScrollArea::resizeEvent(event);
-        render();
-    });
+    if (!isVisible() || !d->documentContainer.hasDocument()) {
+        withFixedTextPosition([this, event] {
+            QAbstractScrollArea::resizeEvent(event);
+            render();
+        });
+        return;
+    }
+    // laying out large documents is expensive, so only do that again when resizing settles,
+    // and show the current layout in the meantime
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+    d->relayoutTimer.start();
+}
+
+void QLiteHtmlWidget::changeEvent(QEvent *event)
+{
+    if (event->type() == QEvent::PaletteChange) {
+        // the selection is drawn with the palette's highlight color
+        d->tiles.clear();
+        viewport()->update();
+    }
+    QAbstractScrollArea::changeEvent(event);
 }
 
 void QLiteHtmlWidget::mouseMoveEvent(QMouseEvent *event)
@@ -583,7 +645,7 @@ void QLiteHtmlWidget::mouseMoveEvent(QMouseEvent *event)
     htmlPos(event->pos(), &viewportPos, &pos);
     const QVector<QRect> areas = d->documentContainer.mouseMoveEvent(pos, viewportPos);
     for (const QRect &r : areas)
-        viewport()->update(fromVirtual(r.translated(-scrollPosition())));
+        updateDocumentArea(r);
 
     updateHightlightedLink();
 }
@@ -595,7 +657,7 @@ void QLiteHtmlWidget::mousePressEvent(QMouseEvent *event)
     htmlPos(event->pos(), &viewportPos, &pos);
     const QVector<QRect> areas = d->documentContainer.mousePressEvent(pos, viewportPos, event->button());
     for (const QRect &r : areas)
-        viewport()->update(fromVirtual(r.translated(-scrollPosition())));
+        updateDocumentArea(r);
 }
 
 void QLiteHtmlWidget::mouseReleaseEvent(QMouseEvent *event)
@@ -605,7 +667,7 @@ void QLiteHtmlWidget::mouseReleaseEvent(QMouseEvent *event)
     htmlPos(event->pos(), &viewportPos, &pos);
     const QVector<QRect> areas = d->documentContainer.mouseReleaseEvent(pos, viewportPos, event->button());
     for (const QRect &r : areas)
-        viewport()->update(fromVirtual(r.translated(-scrollPosition())));
+        updateDocumentArea(r);
 }
 
 void QLiteHtmlWidget::mouseDoubleClickEvent(QMouseEvent *event)
@@ -614,9 +676,8 @@ void QLiteHtmlWidget::mouseDoubleClickEvent(QMouseEvent *event)
     QPoint pos;
     htmlPos(event->pos(), &viewportPos, &pos);
     const QVector<QRect> areas = d->documentContainer.mouseDoubleClickEvent(pos, viewportPos, event->button());
-    for (const QRect &r : areas) {
-        viewport()->update(fromVirtual(r.translated(-scrollPosition())));
-    }
+    for (const QRect &r : areas)
+        updateDocumentArea(r);
 }
 
 void QLiteHtmlWidget::leaveEvent(QEvent *event)
@@ -624,7 +685,7 @@ void QLiteHtmlWidget::leaveEvent(QEvent *event)
     Q_UNUSED(event)
     const QVector<QRect> areas = d->documentContainer.leaveEvent();
     for (const QRect &r : areas)
-        viewport()->update(fromVirtual(r.translated(-scrollPosition())));
+        updateDocumentArea(r);
     setHightlightedLink(QUrl());
 }
 
@@ -698,14 +759,57 @@ void QLiteHtmlWidget::render()
     const QSize vViewportSize = toVirtual(viewport()->size());
     const int scrollbarWidth = style()->pixelMetric(QStyle::PM_ScrollBarExtent, nullptr, this);
     const int w = fullWidth - scrollbarWidth - 2;
+    d->relayoutTimer.stop();
+    d->layoutWidth = w;
     d->documentContainer.render(w, vViewportSize.height());
+    d->tiles.clear();
+    updateScrollBars();
+    viewport()->update();
+}
+
+void QLiteHtmlWidget::updateScrollBars()
+{
+    const QSize vViewportSize = toVirtual(viewport()->size());
     // scroll bars reflect virtual/scaled size of html document
     horizontalScrollBar()->setPageStep(vViewportSize.width());
-    horizontalScrollBar()->setRange(0, std::max(0, d->documentContainer.documentWidth() - w));
+    horizontalScrollBar()
+        ->setRange(0, std::max(0, d->documentContainer.documentWidth() - d->layoutWidth));
     verticalScrollBar()->setPageStep(vViewportSize.height());
     verticalScrollBar()
         ->setRange(0, std::max(0, d->documentContainer.documentHeight() - vViewportSize.height()));
-    viewport()->update();
+}
+
+QPixmap QLiteHtmlWidget::renderTile(const QPoint &tile)
+{
+    const QRect rect = tileRect(tile);
+    QPixmap pixmap(rect.size() * d->tileDevicePixelRatio);
+    pixmap.setDevicePixelRatio(d->tileDevicePixelRatio);
+    pixmap.fill(Qt::transparent);
+    QPainter p(&pixmap);
+    p.setWorldTransform(QTransform::fromTranslate(-rect.x(), -rect.y())
+                            .scale(d->zoomFactor, d->zoomFactor));
+    p.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    p.setRenderHint(QPainter::Antialiasing, true);
+    // the transformation takes care of positioning, so draw relative to the document's origin
+    d->documentContainer.setScrollPosition({0, 0});
+    d->documentContainer.draw(&p, toVirtual(rect).adjusted(-1, -1, 1, 1));
+    return pixmap;
+}
+
+QRect QLiteHtmlWidget::tileRect(const QPoint &tile) const
+{
+    return {tile * kTileSize, QSize(kTileSize, kTileSize)};
+}
+
+void QLiteHtmlWidget::updateDocumentArea(const QRect &r)
+{
+    if (r.isEmpty())
+        return;
+    const QRect zoomed = fromVirtual(r);
+    d->tiles.removeIf([this, &zoomed](const auto &it) {
+        return tileRect(it.key()).intersects(zoomed);
+    });
+    viewport()->update(zoomed.translated(-zoomedScrollPosition()));
 }
 
 QPoint QLiteHtmlWidget::scrollPosition() const
@@ -713,6 +817,12 @@ QPoint QLiteHtmlWidget::scrollPosition() const
     return {horizontalScrollBar()->value(), verticalScrollBar()->value()};
 }
 
+QPoint QLiteHtmlWidget::zoomedScrollPosition() const
+{
+    return {qRound(horizontalScrollBar()->value() * d->zoomFactor),
+            qRound(verticalScrollBar()->value() * d->zoomFactor)};
+}
+
 void QLiteHtmlWidget::htmlPos(const QPoint &pos, QPoint *viewportPos, QPoint *htmlPos) const
 {
     *viewportPos = toVirtual(viewport()->mapFromParent(pos));
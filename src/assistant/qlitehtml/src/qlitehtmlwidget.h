@@ -55,6 +55,7 @@ signals:
 protected:
     void paintEvent(QPaintEvent *event) override;
     void resizeEvent(QResizeEvent *event) override;
+    void changeEvent(QEvent *event) override;
     void mouseMoveEvent(QMouseEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
     void mouseReleaseEvent(QMouseEvent *event) override;
@@ -68,7 +69,12 @@ private:
     void setHightlightedLink(const QUrl &url);
     void withFixedTextPosition(const std::function<void()> &action);
     void render();
+    void updateScrollBars();
+    QPixmap renderTile(const QPoint &tile);
+    QRect tileRect(const QPoint &tile) const;
+    void updateDocumentArea(const QRect &r);
     QPoint scrollPosition() const;
+    QPoint zoomedScrollPosition() const;
     void htmlPos(const QPoint &pos, QPoint *viewportPos, QPoint *htmlPos) const;
     QPoint toVirtual(const QPoint &p) const;
     QSize toVirtual(const QSize &s) const;
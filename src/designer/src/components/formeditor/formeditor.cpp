@@ -38,6 +38,8 @@
 #include <qdesigner_introspection_p.h>
 #include <qdesigner_qsettings_p.h>
 
+#include <QtCore/qstandardpaths.h>
+
 QT_BEGIN_NAMESPACE
 
 using namespace Qt::StringLiterals;
@@ -119,6 +121,9 @@ FormEditor::FormEditor(const QStringList &pluginPaths,
     setPromotion(new QDesignerPromotion(this));
 
     QtResourceModel *resourceModel = new QtResourceModel(this);
+    const QString cacheLocation = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!cacheLocation.isEmpty())
+        resourceModel->setCacheDirectory(cacheLocation + "/rcc"_L1);
     setResourceModel(resourceModel);
     connect(resourceModel, &QtResourceModel::qrcFileModifiedExternally,
             this, &FormEditor::slotQrcFileChangedExternally);
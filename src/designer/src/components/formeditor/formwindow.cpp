@@ -1609,6 +1609,15 @@ QString FormWindow::contents() const
     return QString::fromUtf8(b.buffer());
 }
 
+DomUI *FormWindow::createPreviewDom() const
+{
+    if (!mainContainer())
+        return nullptr;
+
+    QDesignerResource resource(const_cast<FormWindow*>(this));
+    return resource.createDomUi(mainContainer());
+}
+
 #if QT_CONFIG(clipboard)
 void FormWindow::copy()
 {
@@ -2406,6 +2415,7 @@ bool FormWindow::isDirty() const
 
 void FormWindow::setDirty(bool dirty)
 {
+    invalidatePreviewDom();
     if (dirty)
         m_undoStack.resetClean();
     else
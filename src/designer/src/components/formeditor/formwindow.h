@@ -207,6 +207,7 @@ public slots:
 
 protected:
     virtual QMenu *createPopupMenu(QWidget *w);
+    DomUI *createPreviewDom() const override;
     void resizeEvent(QResizeEvent *e) override;
 
     void insertWidget(QWidget *w, QRect rect, QWidget *target, bool already_in_form = false);
@@ -507,6 +507,19 @@ void QDesignerResource::save(QIODevice *dev, QWidget *widget)
     QAbstractFormBuilder::save(dev, widget);
 }
 
+DomUI *QDesignerResource::createDomUi(QWidget *widget)
+{
+    d->m_fullyQualifiedEnums = supportsQualifiedEnums(qtVersion(m_formWindow->core()));
+    DomWidget *ui_widget = createDom(widget, nullptr);
+    Q_ASSERT(ui_widget != nullptr);
+
+    DomUI *ui = QFormBuilderExtra::createDomUi(ui_widget);
+    saveDom(ui, widget);
+
+    d->m_laidout.clear();
+    return ui;
+}
+
 void QDesignerResource::saveDom(DomUI *ui, QWidget *widget)
 {
     QAbstractFormBuilder::saveDom(ui, widget);
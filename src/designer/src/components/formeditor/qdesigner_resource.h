@@ -41,6 +41,8 @@ public:
     ~QDesignerResource() override;
 
     void save(QIODevice *dev, QWidget *widget) override;
+    // Creates the DOM that save() would write, without serializing it.
+    DomUI *createDomUi(QWidget *widget);
 
     bool copy(QIODevice *dev, const FormBuilderClipboard &selection) override;
     DomUI *copy(const FormBuilderClipboard &selection) override;
@@ -20,6 +20,8 @@
 #include <QtDesigner/taskmenu.h>
 #include <QtDesigner/abstractintegration.h>
 
+#include <QtDesigner/private/ui4_p.h>
+
 #include <QtWidgets/qmenu.h>
 #include <QtWidgets/qlistwidget.h>
 #include <QtWidgets/qtreewidget.h>
@@ -65,6 +67,7 @@ public:
     FormWindowBase::ResourceFileSaveMode m_saveResourcesBehaviour;
     bool m_useIdBasedTranslations;
     bool m_connectSlotsByName;
+    mutable std::shared_ptr<DomUI> m_previewDom;
 };
 
 FormWindowBasePrivate::FormWindowBasePrivate(QDesignerFormEditorInterface *core) :
@@ -93,6 +96,14 @@ FormWindowBase::FormWindowBase(QDesignerFormEditorInterface *core, QWidget *pare
     m_d->m_iconCache = new DesignerIconCache(m_d->m_pixmapCache, this);
     if (core->integration()->hasFeature(QDesignerIntegrationInterface::DefaultWidgetActionFeature))
         connect(this, &QDesignerFormWindowInterface::activated, this, &FormWindowBase::triggerDefaultAction);
+    connect(this, &QDesignerFormWindowInterface::changed,
+            this, &FormWindowBase::invalidatePreviewDom);
+    connect(this, &QDesignerFormWindowInterface::geometryChanged,
+            this, &FormWindowBase::invalidatePreviewDom);
+    connect(this, &QDesignerFormWindowInterface::resourceFilesChanged,
+            this, &FormWindowBase::invalidatePreviewDom);
+    connect(this, &QDesignerFormWindowInterface::mainContainerChanged,
+            this, &FormWindowBase::invalidatePreviewDom);
 }
 
 FormWindowBase::~FormWindowBase()
@@ -203,6 +214,7 @@ void FormWindowBase::sheetDestroyed(QObject *object)
 
 void FormWindowBase::reloadProperties()
 {
+    invalidatePreviewDom();
     pixmapCache()->clear();
     iconCache()->clear();
     for (auto it = m_d->m_reloadableResources.cbegin(), end = m_d->m_reloadableResources.cend(); it != end; ++it) {
@@ -525,6 +537,23 @@ void FormWindowBase::setConnectSlotsByName(bool v)
     m_d->m_connectSlotsByName = v;
 }
 
+std::shared_ptr<DomUI> FormWindowBase::previewDom() const
+{
+    if (!m_d->m_previewDom)
+        m_d->m_previewDom.reset(createPreviewDom());
+    return m_d->m_previewDom;
+}
+
+DomUI *FormWindowBase::createPreviewDom() const
+{
+    return nullptr;
+}
+
+void FormWindowBase::invalidatePreviewDom()
+{
+    m_d->m_previewDom.reset();
+}
+
 QStringList FormWindowBase::checkContents() const
 {
     if (!mainContainer())
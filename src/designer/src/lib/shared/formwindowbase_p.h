@@ -22,8 +22,11 @@
 #include <QtCore/qvariant.h>
 #include <QtCore/qlist.h>
 
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
+class DomUI;
 class QDesignerDnDItemInterface;
 class QMenu;
 class QtResourceSet;
@@ -143,9 +146,17 @@ public:
     bool connectSlotsByName() const;
     void setConnectSlotsByName(bool v);
 
+    // DOM of the form for building previews, cached until the form changes.
+    std::shared_ptr<DomUI> previewDom() const;
+
 public slots:
     void resourceSetActivated(QtResourceSet *resourceSet, bool resourceSetChanged);
 
+protected:
+    // Overwrite to create the DOM of the form for previewDom()
+    virtual DomUI *createPreviewDom() const;
+    void invalidatePreviewDom();
+
 private slots:
     void triggerDefaultAction(QWidget *w);
     void sheetDestroyed(QObject *object);
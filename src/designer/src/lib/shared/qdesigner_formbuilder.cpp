@@ -303,12 +303,18 @@ QWidget *QDesignerFormBuilder::createPreview(const QDesignerFormWindowInterface
     QDesignerFormBuilder builder(fw->core(), deviceProfile);
     builder.setWorkingDirectory(fw->absoluteDir());
 
-    QByteArray bytes = fw->contents().toUtf8();
-
-    QBuffer buffer(&bytes);
-    buffer.open(QIODevice::ReadOnly);
-
-    QWidget *widget = builder.load(&buffer, nullptr);
+    // Build directly from the (cached) DOM of the form if available, avoiding
+    // the XML round trip.
+    QWidget *widget = nullptr;
+    const auto *fwb = qobject_cast<const FormWindowBase *>(fw);
+    if (const std::shared_ptr<DomUI> ui = fwb ? fwb->previewDom() : std::shared_ptr<DomUI>()) {
+        widget = builder.create(ui.get(), nullptr);
+    } else {
+        QByteArray bytes = fw->contents().toUtf8();
+        QBuffer buffer(&bytes);
+        buffer.open(QIODevice::ReadOnly);
+        widget = builder.load(&buffer, nullptr);
+    }
     if (!widget) { // Shouldn't happen
         *errorMessage = QCoreApplication::translate("QDesignerFormBuilder", "The preview failed to build.");
         return  nullptr;
@@ -33,6 +33,8 @@
 #include <QtCore/qdebug.h>
 #include <QtCore/qhash.h>
 
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
 using namespace Qt::StringLiterals;
@@ -189,6 +191,18 @@ public:
         PropertyKind kind = NormalProperty;
     };
 
+    // Class-invariant information about the meta properties, shared by the sheets
+    // of all objects of a class.
+    struct ClassData {
+        QList<Info> info; // Indexed by meta property index
+        // Index and type of the properties that need per-object setup
+        QList<std::pair<int, int>> specialProperties;
+    };
+    static std::shared_ptr<const ClassData> classData(const QDesignerMetaObjectInterface *meta,
+                                                      const QMetaObject *metaObject);
+
+    // m_info only stores the per-object overrides of the class data
+    const Info &info(int index) const;
     Info &ensureInfo(int index);
 
     QDesignerPropertySheet *q;
@@ -197,6 +211,7 @@ public:
     const ObjectType m_objectType;
     const ObjectFlags m_objectFlags;
 
+    std::shared_ptr<const ClassData> m_classData;
     QHash<int, Info> m_info;
     QHash<int, QVariant> m_fakeProperties;
     QHash<int, QVariant> m_addProperties;
@@ -267,7 +282,7 @@ QVariant QDesignerPropertySheetPrivate::emptyResourceProperty(int index) const
 
 QVariant QDesignerPropertySheetPrivate::defaultResourceProperty(int index) const
 {
-    return m_info.value(index).defaultValue;
+    return info(index).defaultValue;
 }
 
 QVariant QDesignerPropertySheetPrivate::resourceProperty(int index) const
@@ -419,20 +434,77 @@ QLayout* QDesignerPropertySheetPrivate::layout(QDesignerPropertySheetExtension *
     return  m_lastLayout;
 }
 
+std::shared_ptr<const QDesignerPropertySheetPrivate::ClassData>
+    QDesignerPropertySheetPrivate::classData(const QDesignerMetaObjectInterface *meta,
+                                             const QMetaObject *metaObject)
+{
+    // The introspection meta objects are created from the QMetaObject, so that is used as key
+    static QHash<const QMetaObject *, std::shared_ptr<const ClassData>> classDataHash;
+    const auto it = classDataHash.constFind(metaObject);
+    if (it != classDataHash.constEnd())
+        return it.value();
+
+    const QDesignerMetaObjectInterface *baseMeta = meta;
+    while (baseMeta && baseMeta->className().startsWith("QDesigner"_L1))
+        baseMeta = baseMeta->superClass();
+    Q_ASSERT(baseMeta != nullptr);
+
+    auto data = std::make_shared<ClassData>();
+    const int propertyCount = meta->propertyCount();
+    data->info.reserve(propertyCount);
+    for (int index = 0; index < propertyCount; ++index) {
+        const QDesignerMetaPropertyInterface *p = meta->property(index);
+        const int type = p->type();
+        Info info;
+        // Use the default for `real' properties. Key sequences are turned into fake
+        // properties per object, which hides them if they are designable.
+        info.visible = type == QMetaType::QKeySequence;
+        const QDesignerMetaObjectInterface *pmeta = propertyIntroducedBy(baseMeta, index);
+        info.group = pmeta ? pmeta->className() : baseMeta->className();
+        info.propertyType = QDesignerPropertySheet::propertyTypeFromName(p->name());
+        data->info.append(info);
+
+        switch (type) {
+        case QMetaType::QCursor:
+        case QMetaType::QIcon:
+        case QMetaType::QPixmap:
+        case QMetaType::QString:
+        case QMetaType::QStringList:
+        case QMetaType::QKeySequence:
+            data->specialProperties.append({index, type});
+            break;
+        default:
+            break;
+        }
+    }
+    classDataHash.insert(metaObject, data);
+    return data;
+}
+
+const QDesignerPropertySheetPrivate::Info &QDesignerPropertySheetPrivate::info(int index) const
+{
+    const auto it = m_info.constFind(index);
+    if (it != m_info.constEnd())
+        return it.value();
+    if (index >= 0 && index < m_classData->info.size())
+        return m_classData->info.at(index);
+    static const Info defaultInfo;
+    return defaultInfo;
+}
+
 QDesignerPropertySheetPrivate::Info &QDesignerPropertySheetPrivate::ensureInfo(int index)
 {
     auto it = m_info.find(index);
-    if (it == m_info.end())
-        it = m_info.insert(index, Info());
+    if (it == m_info.end()) {
+        const bool isMetaProperty = index >= 0 && index < m_classData->info.size();
+        it = m_info.insert(index, isMetaProperty ? m_classData->info.at(index) : Info());
+    }
     return it.value();
 }
 
 QDesignerPropertySheet::PropertyType QDesignerPropertySheetPrivate::propertyType(int index) const
 {
-    const auto it = m_info.constFind(index);
-    if (it == m_info.constEnd())
-        return QDesignerPropertySheet::PropertyNone;
-    return it.value().propertyType;
+    return info(index).propertyType;
 }
 
 QString QDesignerPropertySheetPrivate::transformLayoutPropertyName(int index) const
@@ -539,13 +611,7 @@ QDesignerPropertySheet::QDesignerPropertySheet(QObject *object, QObject *parent)
     QObject(parent),
     d(new QDesignerPropertySheetPrivate(this, object, parent))
 {
-    using Info = QDesignerPropertySheetPrivate::Info;
-    const QDesignerMetaObjectInterface *baseMeta = d->m_meta;
-
-    while (baseMeta &&baseMeta->className().startsWith("QDesigner"_L1)) {
-        baseMeta = baseMeta->superClass();
-    }
-    Q_ASSERT(baseMeta != nullptr);
+    d->m_classData = QDesignerPropertySheetPrivate::classData(d->m_meta, object->metaObject());
 
     QDesignerFormWindowInterface *formWindow = QDesignerFormWindowInterface::findFormWindow(d->m_object);
     d->m_fwb = qobject_cast<qdesigner_internal::FormWindowBase *>(formWindow);
@@ -555,31 +621,15 @@ QDesignerPropertySheet::QDesignerPropertySheet(QObject *object, QObject *parent)
         d->m_fwb->addReloadablePropertySheet(this, object);
     }
 
-    for (int index=0; index<count(); ++index) {
+    // Groups, types and visibility of the meta properties come from the shared class data,
+    // only the properties that depend on the object are set up here.
+    for (const auto &[index, type] : d->m_classData->specialProperties) {
         const QDesignerMetaPropertyInterface *p = d->m_meta->property(index);
-        const QString name = p->name();
-        if (p->type() == QMetaType::QKeySequence) {
-            createFakeProperty(name);
-        } else {
-            setVisible(index, false); // use the default for `real' properties
-        }
-
-        QString pgroup = baseMeta->className();
-
-        if (const QDesignerMetaObjectInterface *pmeta = propertyIntroducedBy(baseMeta, index)) {
-            pgroup = pmeta->className();
-        }
-
-        Info &info = d->ensureInfo(index);
-        info.group = pgroup;
-        info.propertyType = propertyTypeFromName(name);
-
-        const int type = p->type();
         switch (type) {
         case QMetaType::QCursor:
         case QMetaType::QIcon:
         case QMetaType::QPixmap:
-            info.defaultValue = p->read(d->m_object);
+            d->ensureInfo(index).defaultValue = p->read(d->m_object);
             if (type == QMetaType::QIcon || type == QMetaType::QPixmap)
                 d->addResourceProperty(index, type);
             break;
@@ -590,6 +640,7 @@ QDesignerPropertySheet::QDesignerPropertySheet(QObject *object, QObject *parent)
             d->addStringListProperty(index);
             break;
         case QMetaType::QKeySequence:
+            createFakeProperty(p->name());
             d->addKeySequenceProperty(index);
             break;
         default:
@@ -828,14 +879,14 @@ bool QDesignerPropertySheet::isDynamicProperty(int index) const
     // if someone implements a property sheet only, omitting the dynamic sheet.
     if (index < 0 || index >= count())
         return false;
-    return d->m_info.value(index).kind == QDesignerPropertySheetPrivate::DynamicProperty;
+    return d->info(index).kind == QDesignerPropertySheetPrivate::DynamicProperty;
 }
 
 bool QDesignerPropertySheet::isDefaultDynamicProperty(int index) const
 {
     if (d->invalidIndex(Q_FUNC_INFO, index))
         return false;
-    return d->m_info.value(index).kind == QDesignerPropertySheetPrivate::DefaultDynamicProperty;
+    return d->info(index).kind == QDesignerPropertySheetPrivate::DefaultDynamicProperty;
 }
 
 bool QDesignerPropertySheet::isResourceProperty(int index) const
@@ -962,7 +1013,7 @@ QString QDesignerPropertySheet::propertyGroup(int index) const
 {
     if (d->invalidIndex(Q_FUNC_INFO, index))
         return QString();
-    const QString g = d->m_info.value(index).group;
+    const QString g = d->info(index).group;
 
     if (!g.isEmpty())
         return g;
@@ -1234,7 +1285,7 @@ bool QDesignerPropertySheet::hasReset(int index) const
     if (d->invalidIndex(Q_FUNC_INFO, index))
         return false;
     if (isAdditionalProperty(index))
-        return d->m_info.value(index).reset;
+        return d->info(index).reset;
     return true;
 }
 
@@ -1270,7 +1321,7 @@ bool QDesignerPropertySheet::reset(int index)
     if (isDynamic(index)) {
         const QString propName = propertyName(index);
         const QVariant oldValue = d->m_addProperties.value(index);
-        const QVariant defaultValue = d->m_info.value(index).defaultValue;
+        const QVariant defaultValue = d->info(index).defaultValue;
         QVariant newValue = defaultValue;
         if (d->isStringProperty(index)) {
             newValue = QVariant::fromValue(qdesigner_internal::PropertySheetStringValue(newValue.toString()));
@@ -1285,8 +1336,8 @@ bool QDesignerPropertySheet::reset(int index)
         d->m_object->setProperty(propName.toUtf8(), defaultValue);
         d->m_addProperties[index] = newValue;
         return true;
-    } else if (!d->m_info.value(index).defaultValue.isNull()) {
-        setProperty(index, d->m_info.value(index).defaultValue);
+    } else if (!d->info(index).defaultValue.isNull()) {
+        setProperty(index, d->info(index).defaultValue);
         return true;
     }
     if (isAdditionalProperty(index)) {
@@ -1384,7 +1435,7 @@ bool QDesignerPropertySheet::isChanged(int index) const
             }
         }
     }
-    return d->m_info.value(index).changed;
+    return d->info(index).changed;
 }
 
 void QDesignerPropertySheet::setChanged(int index, bool changed)
@@ -1496,21 +1547,21 @@ bool QDesignerPropertySheet::isVisible(int index) const
             }
             return true;
         }
-        return d->m_info.value(index).visible;
+        return d->info(index).visible;
     }
 
     if (isFakeProperty(index)) {
         switch (type) {
         case PropertyWindowModality: // Hidden for child widgets
         case PropertyWindowOpacity:
-            return d->m_info.value(index).visible;
+            return d->info(index).visible;
         default:
             break;
         }
         return true;
     }
 
-    const bool visible = d->m_info.value(index).visible;
+    const bool visible = d->info(index).visible;
     switch (type) {
     case PropertyWindowTitle:
     case PropertyWindowIcon:
@@ -1556,7 +1607,7 @@ bool QDesignerPropertySheet::isEnabled(int index) const
         return !isManaged || lt == qdesigner_internal::LayoutInfo::NoLayout;
     }
 
-    if (d->m_info.value(index).visible)
+    if (d->info(index).visible)
         return true;
 
     // Enable setting of properties for statically non-designable properties
@@ -1580,12 +1631,12 @@ bool QDesignerPropertySheet::isAttribute(int index) const
     if (d->invalidIndex(Q_FUNC_INFO, index))
         return false;
     if (isAdditionalProperty(index))
-        return d->m_info.value(index).attribute;
+        return d->info(index).attribute;
 
     if (isFakeProperty(index))
         return false;
 
-    return d->m_info.value(index).attribute;
+    return d->info(index).attribute;
 }
 
 void QDesignerPropertySheet::setAttribute(int index, bool attribute)
@@ -13,12 +13,131 @@
 #include <QtCore/qdir.h>
 #include <QtCore/qdebug.h>
 #include <QtCore/qbuffer.h>
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qdatetime.h>
 #include <QtCore/qfilesystemwatcher.h>
+#include <QtCore/qsavefile.h>
+
+#include <memory>
 
 QT_BEGIN_NAMESPACE
 
+using namespace Qt::StringLiterals;
+
 enum { debugResourceModel = 0 };
 
+// Format version of the binary rcc data, part of the cache file hash
+enum { rccFormatVersion = 3 };
+
+// Least recently used cache files are removed beyond this size
+static constexpr qint64 maxCacheDirectorySize = 256 * 1024 * 1024;
+
+// ------------------- QtResourceData
+// Binary rcc data of a .qrc file, either held in memory or memory-mapped
+// from a cache file. The hash covers the .qrc file and all its input files.
+class QtResourceData
+{
+    Q_DISABLE_COPY_MOVE(QtResourceData)
+public:
+    QtResourceData(const QByteArray &hash, const QByteArray &data);
+    QtResourceData(const QByteArray &hash, std::unique_ptr<QFile> file, const uchar *mapped);
+    ~QtResourceData();
+
+    const QByteArray &hash() const { return m_hash; }
+    const uchar *data() const;
+    QString fileName() const { return m_file ? m_file->fileName() : QString(); }
+
+private:
+    const QByteArray m_hash;
+    const QByteArray m_data;
+    std::unique_ptr<QFile> m_file;
+    const uchar *m_mapped = nullptr;
+};
+
+QtResourceData::QtResourceData(const QByteArray &hash, const QByteArray &data) :
+    m_hash(hash),
+    m_data(data)
+{
+}
+
+QtResourceData::QtResourceData(const QByteArray &hash, std::unique_ptr<QFile> file,
+                               const uchar *mapped) :
+    m_hash(hash),
+    m_file(std::move(file)),
+    m_mapped(mapped)
+{
+}
+
+QtResourceData::~QtResourceData()
+{
+    if (m_file)
+        m_file->unmap(const_cast<uchar *>(m_mapped));
+}
+
+const uchar *QtResourceData::data() const
+{
+    return m_file ? m_mapped : reinterpret_cast<const uchar *>(m_data.constData());
+}
+
+static QByteArray resourceHash(const QString &path,
+                               const RCCResourceLibrary::ResourceDataFileMap &resMap)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    const auto addString = [&hash](const QString &s) {
+        hash.addData(s.toUtf8());
+        hash.addData(QByteArrayView("\0", 1));
+    };
+    const auto addFile = [&hash](const QString &fileName) {
+        QFile file(fileName);
+        if (file.open(QIODevice::ReadOnly))
+            hash.addData(&file);
+    };
+
+    // Cache files written by a different rcc are not compatible
+    addString(QStringLiteral(QT_VERSION_STR));
+    addString(QString::number(rccFormatVersion));
+    addString(path);
+    addFile(path);
+    for (auto it = resMap.cbegin(), end = resMap.cend(); it != end; ++it) {
+        addString(it.key());
+        addString(it.value());
+        addFile(it.value());
+    }
+    return hash.result();
+}
+
+// Removes the least recently used cache files when the directory is larger
+// than maxCacheDirectorySize, so cache files of .qrc files that are no longer
+// used do not accumulate.
+static void pruneCacheDirectory(const QString &directory)
+{
+    QFileInfoList files = QDir(directory).entryInfoList({u"*.rcc"_s}, QDir::Files,
+                                                        QDir::Time);
+    qint64 size = 0;
+    for (const QFileInfo &file : std::as_const(files))
+        size += file.size();
+    // sorted by modification time, the oldest files are last
+    while (size > maxCacheDirectorySize && !files.isEmpty()) {
+        const QFileInfo file = files.takeLast();
+        if (QFile::remove(file.absoluteFilePath()))
+            size -= file.size();
+    }
+}
+
+// Maps a cache file, returns nullptr on failure
+static QtResourceData *mapResource(const QByteArray &hash, const QString &fileName)
+{
+    auto file = std::make_unique<QFile>(fileName);
+    if (!file->open(QIODevice::ReadOnly) || file->size() == 0)
+        return nullptr;
+    const uchar *mapped = file->map(0, file->size());
+    if (!mapped)
+        return nullptr;
+    // The modification time tells pruneCacheDirectory() when the file was last used
+    file->setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    return new QtResourceData(hash, std::move(file), mapped);
+}
+
 // ------------------- QtResourceSetPrivate
 class QtResourceSetPrivate
 {
@@ -58,7 +177,8 @@ public:
     QMap<QString, QList<QtResourceSet *>> m_pathToResourceSet;
     QtResourceSet                         *m_currentResourceSet = nullptr;
 
-    QMap<QString, const QByteArray *> m_pathToData;
+    QMap<QString, const QtResourceData *> m_pathToData;
+    QString m_cacheDirectory; // write rcc data to files and map them if not empty
 
     QMap<QString, QStringList> m_pathToContents; // qrc path to its contents.
     QMap<QString, QString>     m_fileToQrc; // this map contains the content of active resource set only.
@@ -76,8 +196,10 @@ private:
 
     void slotFileChanged(const QString &);
 
-    const QByteArray *createResource(const QString &path, QStringList *contents, int *errorCount, QIODevice &errorDevice) const;
-    void deleteResource(const QByteArray *data) const;
+    const QtResourceData *createResource(const QString &path, const QtResourceData *oldData,
+                                         QStringList *contents, int *errorCount,
+                                         QIODevice &errorDevice) const;
+    void deleteResource(const QtResourceData *data, bool removeCacheFile = false) const;
 };
 
 QtResourceModelPrivate::QtResourceModelPrivate() = default;
@@ -119,49 +241,91 @@ void QtResourceSet::setModified(const QString &path)
 }
 
 // ------------------- QtResourceModelPrivate
-const QByteArray *QtResourceModelPrivate::createResource(const QString &path, QStringList *contents, int *errorCount, QIODevice &errorDevice) const
+// Creates the rcc data for a .qrc file. Returns oldData if the .qrc file and
+// its input files are unchanged. If a cache directory is set, the data is
+// written to a file named after the hash and memory-mapped; an existing file
+// is reused without running rcc.
+const QtResourceData *QtResourceModelPrivate::createResource(const QString &path,
+                                                             const QtResourceData *oldData,
+                                                             QStringList *contents, int *errorCount,
+                                                             QIODevice &errorDevice) const
 {
     using ResourceDataFileMap = RCCResourceLibrary::ResourceDataFileMap;
-    const QByteArray *rc = nullptr;
+    const QtResourceData *rc = nullptr;
     *errorCount = -1;
     contents->clear();
     do {
         // run RCC
-        RCCResourceLibrary library(3);
+        RCCResourceLibrary library(rccFormatVersion);
         library.setVerbose(true);
         library.setInputFiles(QStringList(path));
         library.setFormat(RCCResourceLibrary::Binary);
 
-        QBuffer buffer;
-        buffer.open(QIODevice::WriteOnly);
         if (!library.readFiles(/* ignore errors*/ true, errorDevice))
             break;
         // return code cannot be fully trusted, might still be empty
         const ResourceDataFileMap resMap = library.resourceDataFileMap();
-        if (!library.output(buffer, buffer /* tempfile, unused */, errorDevice))
-            break;
-
         *errorCount = library.failedResources().size();
         *contents = resMap.keys();
 
         if (resMap.isEmpty())
             break;
 
+        const QByteArray hash = resourceHash(path, resMap);
+        if (oldData && oldData->hash() == hash) {
+            rc = oldData;
+            break;
+        }
+
+        QString cacheFileName;
+        if (!m_cacheDirectory.isEmpty() && QDir().mkpath(m_cacheDirectory)) {
+            cacheFileName = m_cacheDirectory + u'/' + QString::fromLatin1(hash.toHex()) + ".rcc"_L1;
+            if (QFileInfo::exists(cacheFileName)) {
+                rc = mapResource(hash, cacheFileName);
+                if (rc)
+                    break;
+            }
+        }
+
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        if (!library.output(buffer, buffer /* tempfile, unused */, errorDevice)) {
+            contents->clear();
+            *errorCount = -1;
+            break;
+        }
         buffer.close();
-        rc = new QByteArray(buffer.data());
+
+        if (!cacheFileName.isEmpty()) {
+            QSaveFile cacheFile(cacheFileName);
+            if (cacheFile.open(QIODevice::WriteOnly)
+                && cacheFile.write(buffer.data()) == buffer.size() && cacheFile.commit()) {
+                rc = mapResource(hash, cacheFileName);
+                if (rc)
+                    break;
+            }
+            qWarning() << "** WARNING: Failed to write resource cache file " << cacheFileName;
+        }
+        rc = new QtResourceData(hash, buffer.data());
     } while (false);
 
     if (debugResourceModel)
-        qDebug() << "createResource" << path << "returns data=" << rc << " hasWarnings=" << *errorCount;
+        qDebug() << "createResource" << path << "returns data=" << rc
+            << (rc && rc == oldData ? " (unchanged)" : "") << " hasWarnings=" << *errorCount;
     return rc;
 }
 
-void QtResourceModelPrivate::deleteResource(const QByteArray *data) const
+void QtResourceModelPrivate::deleteResource(const QtResourceData *data, bool removeCacheFile) const
 {
     if (data) {
         if (debugResourceModel)
             qDebug() << "deleteResource";
+        const QString fileName = data->fileName();
         delete data;
+        // Stale cache file of a rebuilt .qrc file. Files of .qrc files that are
+        // merely unloaded are kept for later sessions.
+        if (removeCacheFile && !fileName.isEmpty())
+            QFile::remove(fileName);
     }
 }
 
@@ -177,9 +341,9 @@ void QtResourceModelPrivate::registerResourceSet(QtResourceSet *resourceSet)
             qDebug() << "registerResourceSet " << path;
         const auto itRcc = m_pathToData.constFind(path);
         if (itRcc != m_pathToData.constEnd()) { // otherwise data was not created yet
-            const QByteArray *data = itRcc.value();
+            const QtResourceData *data = itRcc.value();
             if (data) {
-                if (!QResource::registerResource(reinterpret_cast<const uchar *>(data->constData()))) {
+                if (!QResource::registerResource(data->data())) {
                     qWarning() << "** WARNING: Failed to register " << path << " (QResource failure).";
                 } else {
                     const QStringList contents = m_pathToContents.value(path);
@@ -205,9 +369,9 @@ void QtResourceModelPrivate::unregisterResourceSet(QtResourceSet *resourceSet)
             qDebug() << "unregisterResourceSet " << path;
         const auto itRcc = m_pathToData.constFind(path);
         if (itRcc != m_pathToData.constEnd()) { // otherwise data was not created yet
-            const QByteArray *data = itRcc.value();
+            const QtResourceData *data = itRcc.value();
             if (data) {
-                if (!QResource::unregisterResource(reinterpret_cast<const uchar *>(itRcc.value()->constData())))
+                if (!QResource::unregisterResource(data->data()))
                     qWarning() << "** WARNING: Failed to unregister " << path << " (QResource failure).";
             }
         }
@@ -244,7 +408,8 @@ void QtResourceModelPrivate::activate(QtResourceSet *resourceSet, const QStringL
             QStringList contents;
             int qrcErrorCount;
             generatedCount++;
-            const QByteArray *data = createResource(path, &contents, &qrcErrorCount, errorStream);
+            const QtResourceData *oldData = m_pathToData.value(path);
+            const QtResourceData *data = createResource(path, oldData, &contents, &qrcErrorCount, errorStream);
 
             newPathToData.insert(path, data);
             if (qrcErrorCount) // Count single failed files as sort of 1/2 error
@@ -252,6 +417,8 @@ void QtResourceModelPrivate::activate(QtResourceSet *resourceSet, const QStringL
             addWatcher(path);
 
             m_pathToModified.insert(path, false);
+            if (data && data == oldData) // inputs unchanged, keep the registered data
+                continue;
             m_pathToContents.insert(path, contents);
             newResourceSetChanged = true;
             const auto itReload = m_pathToResourceSet.find(path);
@@ -270,8 +437,8 @@ void QtResourceModelPrivate::activate(QtResourceSet *resourceSet, const QStringL
     const auto oldData = m_pathToData.values();
     const auto newData = newPathToData.values();
 
-    QList<const QByteArray *> toDelete;
-    for (const QByteArray *array : oldData) {
+    QList<const QtResourceData *> toDelete;
+    for (const QtResourceData *array : oldData) {
         if (array && !newData.contains(array))
             toDelete.append(array);
     }
@@ -310,8 +477,8 @@ void QtResourceModelPrivate::activate(QtResourceSet *resourceSet, const QStringL
     }
 
     if (!newResourceSetChanged && !needReregister && (m_currentResourceSet == resourceSet)) {
-        for (const QByteArray *data : std::as_const(toDelete))
-            deleteResource(data);
+        for (const QtResourceData *data : std::as_const(toDelete))
+            deleteResource(data, true);
 
         return; // nothing changed
     }
@@ -319,8 +486,8 @@ void QtResourceModelPrivate::activate(QtResourceSet *resourceSet, const QStringL
     if (needReregister)
         unregisterResourceSet(m_currentResourceSet);
 
-    for (const QByteArray *data : std::as_const(toDelete))
-        deleteResource(data);
+    for (const QtResourceData *data : std::as_const(toDelete))
+        deleteResource(data, true);
 
     m_pathToData = newPathToData;
     m_currentResourceSet = resourceSet;
@@ -520,6 +687,18 @@ void QtResourceModel::reload(int *errorCount, QString *errorMessages)
     d_ptr->activate(d_ptr->m_currentResourceSet, d_ptr->m_resourceSetToPaths.value(d_ptr->m_currentResourceSet), errorCount, errorMessages);
 }
 
+QString QtResourceModel::cacheDirectory() const
+{
+    return d_ptr->m_cacheDirectory;
+}
+
+void QtResourceModel::setCacheDirectory(const QString &directory)
+{
+    d_ptr->m_cacheDirectory = directory;
+    if (!directory.isEmpty())
+        pruneCacheDirectory(directory);
+}
+
 QMap<QString, QString> QtResourceModel::contents() const
 {
     return d_ptr->m_fileToQrc;
@@ -77,6 +77,13 @@ public:
     void reload(const QString &path, int *errorCount = nullptr, QString *errorMessages = nullptr);
     void reload(int *errorCount = nullptr, QString *errorMessages = nullptr);
 
+    // Directory to which the binary resource data is written to be memory-mapped
+    // instead of being kept in memory (disabled if empty). Files are named by a
+    // content hash, so unchanged .qrc files are not rebuilt across sessions.
+    // Setting it removes the least recently used files if the directory grew too large.
+    QString cacheDirectory() const;
+    void setCacheDirectory(const QString &directory);
+
     // Contents of the current resource set (content file to qrc path)
     QMap<QString, QString> contents() const;
     // Find the qrc file belonging to the contained file (from current resource set)
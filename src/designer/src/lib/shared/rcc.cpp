@@ -14,10 +14,14 @@
 #include <qfile.h>
 #include <qiodevice.h>
 #include <qlocale.h>
+#include <qsemaphore.h>
 #include <qstack.h>
+#include <qthreadpool.h>
 #include <qxmlstream.h>
 
 #include <algorithm>
+#include <memory>
+#include <vector>
 
 #if QT_CONFIG(zstd)
 #  include <zstd.h>
@@ -32,7 +36,8 @@ enum {
     CONSTANT_COMPRESSLEVEL_DEFAULT = -1,
     CONSTANT_ZSTDCOMPRESSLEVEL_CHECK = 1,   // Zstd level to check if compressing is a good idea
     CONSTANT_ZSTDCOMPRESSLEVEL_STORE = 14,  // Zstd level to actually store the data
-    CONSTANT_COMPRESSTHRESHOLD_DEFAULT = 70
+    CONSTANT_COMPRESSTHRESHOLD_DEFAULT = 70,
+    CONSTANT_READAHEAD_LIMIT = 256 * 1024 * 1024 // Input data compressed ahead of the writer
 };
 
 void RCCResourceLibrary::write(const char *str, int len)
@@ -63,6 +68,8 @@ static inline QString msgOpenReadFailed(const QString &fname, const QString &why
 //
 ///////////////////////////////////////////////////////////
 
+struct RCCDataBlob;
+
 class RCCFileInfo
 {
 public:
@@ -91,7 +98,9 @@ public:
     QString resourceName() const;
 
 public:
-    qint64 writeDataBlob(RCCResourceLibrary &lib, qint64 offset, QString *errorMessage);
+    RCCDataBlob readDataBlob(bool verbose, ZSTD_CCtx *&zstdCCtx);
+    qint64 writeDataBlob(RCCResourceLibrary &lib, qint64 offset, const RCCDataBlob &blob,
+                         QString *errorMessage);
     qint64 writeDataName(RCCResourceLibrary &, qint64 offset);
     void writeDataInfo(RCCResourceLibrary &lib);
 
@@ -114,6 +123,17 @@ public:
     qint64 m_childOffset = 0;
 };
 
+// Payload of a file as read and compressed by RCCFileInfo::readDataBlob().
+// That does not touch the library, so it can run in a worker thread.
+struct RCCDataBlob
+{
+    QByteArray data;
+    QByteArray messages; // Diagnostics for the error device
+    QString errorMessage;
+    int flags = RCCFileInfo::NoFlags; // Compression flags
+    bool ok = false;
+};
+
 RCCFileInfo::RCCFileInfo(const QString &name, const QFileInfo &fileInfo, QLocale::Language language,
                          QLocale::Territory territory, uint flags,
                          RCCResourceLibrary::CompressionAlgorithm compressAlgo, int compressLevel,
@@ -217,25 +237,17 @@ void RCCFileInfo::writeDataInfo(RCCResourceLibrary &lib)
     }
 }
 
-qint64 RCCFileInfo::writeDataBlob(RCCResourceLibrary &lib, qint64 offset,
-    QString *errorMessage)
+RCCDataBlob RCCFileInfo::readDataBlob(bool verbose, ZSTD_CCtx *&zstdCCtx)
 {
-    const bool text = lib.m_format == RCCResourceLibrary::C_Code;
-    const bool pass1 = lib.m_format == RCCResourceLibrary::Pass1;
-    const bool pass2 = lib.m_format == RCCResourceLibrary::Pass2;
-    const bool binary = lib.m_format == RCCResourceLibrary::Binary;
-    const bool python = lib.m_format == RCCResourceLibrary::Python_Code;
-
-    //capture the offset
-    m_dataOffset = offset;
-    QByteArray data;
+    RCCDataBlob blob;
+    QByteArray &data = blob.data;
 
     if (!m_isEmpty) {
         //find the data to be written
         QFile file(m_fileInfo.absoluteFilePath());
         if (!file.open(QFile::ReadOnly)) {
-            *errorMessage = msgOpenReadFailed(m_fileInfo.absoluteFilePath(), file.errorString());
-            return 0;
+            blob.errorMessage = msgOpenReadFailed(m_fileInfo.absoluteFilePath(), file.errorString());
+            return blob;
         }
 
         data = file.readAll();
@@ -249,8 +261,8 @@ qint64 RCCFileInfo::writeDataBlob(RCCResourceLibrary &lib, qint64 offset,
             m_compressLevel = 19;   // not ZSTD_maxCLevel(), as 20+ are experimental
         }
         if (m_compressAlgo == RCCResourceLibrary::CompressionAlgorithm::Zstd && !m_noZstd) {
-            if (lib.m_zstdCCtx == nullptr)
-                lib.m_zstdCCtx = ZSTD_createCCtx();
+            if (zstdCCtx == nullptr)
+                zstdCCtx = ZSTD_createCCtx();
             qsizetype size = data.size();
             size = ZSTD_COMPRESSBOUND(size);
 
@@ -260,36 +272,37 @@ qint64 RCCFileInfo::writeDataBlob(RCCResourceLibrary &lib, qint64 offset,
 
             QByteArray compressed(size, Qt::Uninitialized);
             char *dst = const_cast<char *>(compressed.constData());
-            size_t n = ZSTD_compressCCtx(lib.m_zstdCCtx, dst, size,
+            size_t n = ZSTD_compressCCtx(zstdCCtx, dst, size,
                                          data.constData(), data.size(),
                                          compressLevel);
             if (n * 100.0 < data.size() * 1.0 * (100 - m_compressThreshold) ) {
                 // compressing is worth it
                 if (m_compressLevel < 0) {
                     // heuristic compression, so recompress
-                    n = ZSTD_compressCCtx(lib.m_zstdCCtx, dst, size,
+                    n = ZSTD_compressCCtx(zstdCCtx, dst, size,
                                           data.constData(), data.size(),
                                           CONSTANT_ZSTDCOMPRESSLEVEL_STORE);
                 }
                 if (ZSTD_isError(n)) {
                     QString msg = QString::fromLatin1("%1: error: compression with zstd failed: %2\n")
                             .arg(m_name, QString::fromUtf8(ZSTD_getErrorName(n)));
-                    lib.m_errorDevice->write(msg.toUtf8());
-                } else if (lib.verbose()) {
+                    blob.messages += msg.toUtf8();
+                } else if (verbose) {
                     QString msg = QString::fromLatin1("%1: note: compressed using zstd (%2 -> %3)\n")
                             .arg(m_name).arg(data.size()).arg(n);
-                    lib.m_errorDevice->write(msg.toUtf8());
+                    blob.messages += msg.toUtf8();
                 }
 
-                lib.m_overallFlags |= CompressedZstd;
-                m_flags |= CompressedZstd;
+                blob.flags |= CompressedZstd;
                 data = std::move(compressed);
                 data.truncate(n);
-            } else if (lib.verbose()) {
+            } else if (verbose) {
                 QString msg = QString::fromLatin1("%1: note: not compressed\n").arg(m_name);
-                lib.m_errorDevice->write(msg.toUtf8());
+                blob.messages += msg.toUtf8();
             }
         }
+#else
+        Q_UNUSED(zstdCCtx);
 #endif
 #ifndef QT_NO_COMPRESS
         if (m_compressAlgo == RCCResourceLibrary::CompressionAlgorithm::Best) {
@@ -302,22 +315,48 @@ qint64 RCCFileInfo::writeDataBlob(RCCResourceLibrary &lib, qint64 offset,
 
             int compressRatio = int(100.0 * (data.size() - compressed.size()) / data.size());
             if (compressRatio >= m_compressThreshold) {
-                if (lib.verbose()) {
+                if (verbose) {
                     QString msg = QString::fromLatin1("%1: note: compressed using zlib (%2 -> %3)\n")
                             .arg(m_name).arg(data.size()).arg(compressed.size());
-                    lib.m_errorDevice->write(msg.toUtf8());
+                    blob.messages += msg.toUtf8();
                 }
                 data = compressed;
-                lib.m_overallFlags |= Compressed;
-                m_flags |= Compressed;
-            } else if (lib.verbose()) {
+                blob.flags |= Compressed;
+            } else if (verbose) {
                 QString msg = QString::fromLatin1("%1: note: not compressed\n").arg(m_name);
-                lib.m_errorDevice->write(msg.toUtf8());
+                blob.messages += msg.toUtf8();
             }
         }
 #endif // QT_NO_COMPRESS
     }
 
+
+    blob.ok = true;
+    return blob;
+}
+
+qint64 RCCFileInfo::writeDataBlob(RCCResourceLibrary &lib, qint64 offset,
+    const RCCDataBlob &blob, QString *errorMessage)
+{
+    const bool text = lib.m_format == RCCResourceLibrary::C_Code;
+    const bool pass1 = lib.m_format == RCCResourceLibrary::Pass1;
+    const bool pass2 = lib.m_format == RCCResourceLibrary::Pass2;
+    const bool binary = lib.m_format == RCCResourceLibrary::Binary;
+    const bool python = lib.m_format == RCCResourceLibrary::Python_Code;
+
+    //capture the offset
+    m_dataOffset = offset;
+    if (!blob.ok) {
+        *errorMessage = blob.errorMessage;
+        return 0;
+    }
+
+    if (!blob.messages.isEmpty())
+        lib.m_errorDevice->write(blob.messages);
+    lib.m_overallFlags |= blob.flags;
+    m_flags |= blob.flags;
+    const QByteArray &data = blob.data;
+
     // some info
     if (text || pass1) {
         lib.writeString("  // ");
@@ -1147,23 +1186,95 @@ bool RCCResourceLibrary::writeDataBlobs()
 
     QStack<RCCFileInfo*> pending;
     pending.push(m_root);
-    qint64 offset = 0;
-    QString errorMessage;
+    QList<RCCFileInfo *> files;
+    QList<qint64> fileSizes;
     while (!pending.isEmpty()) {
         RCCFileInfo *file = pending.pop();
         for (auto it = file->m_children.cbegin(); it != file->m_children.cend(); ++it) {
             RCCFileInfo *child = it.value();
-            if (child->m_flags & RCCFileInfo::Directory)
+            if (child->m_flags & RCCFileInfo::Directory) {
                 pending.push(child);
-            else {
-                offset = child->writeDataBlob(*this, offset, &errorMessage);
-                if (offset == 0) {
-                    m_errorDevice->write(errorMessage.toUtf8());
-                    return false;
-                }
+            } else {
+                files.append(child);
+                fileSizes.append(child->m_isEmpty ? 0 : child->m_fileInfo.size());
             }
         }
     }
+
+    qint64 offset = 0;
+    QString errorMessage;
+    const auto writeBlob = [this, &offset, &errorMessage](RCCFileInfo *file,
+                                                          const RCCDataBlob &blob) {
+        offset = file->writeDataBlob(*this, offset, blob, &errorMessage);
+        if (offset == 0) {
+            m_errorDevice->write(errorMessage.toUtf8());
+            return false;
+        }
+        return true;
+    };
+
+#if QT_CONFIG(thread)
+    if (files.size() > 1) {
+        // Read and compress the files in a worker pool ahead of the writer,
+        // which consumes them in order. The input data in flight is capped.
+        struct Job
+        {
+            RCCFileInfo *file = nullptr;
+            RCCDataBlob blob;
+            QSemaphore done;
+        };
+        struct ZstdContext
+        {
+            ZSTD_CCtx *cctx = nullptr;
+            ~ZstdContext()
+            {
+#if QT_CONFIG(zstd)
+                ZSTD_freeCCtx(cctx);
+#endif
+            }
+        };
+
+        std::vector<std::unique_ptr<Job>> jobs(files.size());
+        QThreadPool pool; // declared after the jobs, waits for them when bailing out
+        const bool verbose = m_verbose;
+        qsizetype scheduled = 0;
+        qint64 readAheadSize = 0;
+        for (qsizetype i = 0; i < files.size(); ++i) {
+            while (scheduled < files.size()
+                   && (scheduled == i || readAheadSize < CONSTANT_READAHEAD_LIMIT)) {
+                jobs[scheduled] = std::make_unique<Job>();
+                Job *job = jobs[scheduled].get();
+                job->file = files.at(scheduled);
+                pool.start([job, verbose] {
+                    static thread_local ZstdContext zstdContext;
+                    job->blob = job->file->readDataBlob(verbose, zstdContext.cctx);
+                    job->done.release();
+                });
+                readAheadSize += fileSizes.at(scheduled);
+                ++scheduled;
+            }
+            Job *job = jobs[i].get();
+            job->done.acquire();
+            if (!writeBlob(job->file, job->blob)) {
+                pool.clear();
+                return false;
+            }
+            readAheadSize -= fileSizes.at(i);
+            jobs[i].reset();
+        }
+    } else
+#endif // QT_CONFIG(thread)
+    {
+        for (RCCFileInfo *file : std::as_const(files)) {
+#if QT_CONFIG(zstd)
+            ZSTD_CCtx *&zstdCCtx = m_zstdCCtx;
+#else
+            ZSTD_CCtx *zstdCCtx = nullptr;
+#endif
+            if (!writeBlob(file, file->readDataBlob(m_verbose, zstdCCtx)))
+                return false;
+        }
+    }
     switch (m_format) {
     case C_Code:
         writeString("\n};\n\n");
@@ -890,6 +890,13 @@ bool QAbstractFormBuilder::applyPropertyInternally(QObject *o, const QString &pr
 
 QVariant QAbstractFormBuilder::toVariant(const QMetaObject *meta, DomProperty *p)
 {
+    if (auto *cache = d->m_propertyValueCache) {
+        const QFormBuilderExtra::PropertyValueCache::key_type key(meta, p);
+        auto it = cache->find(key);
+        if (it == cache->end())
+            it = cache->insert(key, domPropertyToVariant(this, meta, p));
+        return it.value();
+    }
     return domPropertyToVariant(this, meta, p);
 }
 
@@ -994,9 +1001,7 @@ void QAbstractFormBuilder::save(QIODevice *dev, QWidget *widget)
     DomWidget *ui_widget = createDom(widget, nullptr);
     Q_ASSERT( ui_widget != nullptr );
 
-    DomUI *ui = new DomUI();
-    ui->setAttributeVersion(u"4.0"_s);
-    ui->setElementWidget(ui_widget);
+    DomUI *ui = QFormBuilderExtra::createDomUi(ui_widget);
 
     saveDom(ui, widget);
 
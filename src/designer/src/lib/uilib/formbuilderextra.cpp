@@ -147,6 +147,14 @@ QString QFormBuilderExtra::msgInvalidUiFile()
     return QCoreApplication::translate("QAbstractFormBuilder", "Invalid UI file");
 }
 
+DomUI *QFormBuilderExtra::createDomUi(DomWidget *uiWidget)
+{
+    DomUI *ui = new DomUI();
+    ui->setAttributeVersion(u"4.0"_s);
+    ui->setElementWidget(uiWidget);
+    return ui;
+}
+
 bool QFormBuilderExtra::applyPropertyInternally(QObject *o, const QString &propertyName, const QVariant &value)
 {
     // Store buddies and apply them later on as the widgets might not exist yet.
@@ -22,6 +22,7 @@
 #include <QtCore/qstringlist.h>
 #include <QtCore/qmap.h>
 #include <QtCore/qdir.h>
+#include <QtCore/qvariant.h>
 #include <QtGui/qpalette.h>
 
 QT_BEGIN_NAMESPACE
@@ -51,6 +52,7 @@ class DomCustomWidget;
 class DomPalette;
 class DomProperty;
 class DomUI;
+class DomWidget;
 
 class QAbstractFormBuilder;
 class QResourceBuilder;
@@ -78,6 +80,9 @@ public:
 
     DomUI *readUi(QIODevice *dev);
     static QString msgInvalidUiFile();
+    // Creates the document of a form around the DOM of its main container,
+    // to be completed by QAbstractFormBuilder::saveDom().
+    static DomUI *createDomUi(DomWidget *uiWidget);
 
     bool applyPropertyInternally(QObject *o, const QString &propertyName, const QVariant &value);
 
@@ -164,6 +169,11 @@ public:
     QString m_errorString;
     QString m_language;
 
+    // Property values converted from a DOM that is instantiated repeatedly,
+    // set while creating a form from a cached DomUI.
+    using PropertyValueCache = QHash<std::pair<const QMetaObject *, const DomProperty *>, QVariant>;
+    PropertyValueCache *m_propertyValueCache = nullptr;
+
 private:
     void clearResourceBuilder();
     void clearTextBuilder();
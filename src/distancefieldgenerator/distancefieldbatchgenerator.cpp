@@ -0,0 +1,246 @@
+// Copyright (C) 2018 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include "distancefieldbatchgenerator.h"
+#include "distancefieldmodel.h"
+
+#include <QtCore/qdebug.h>
+#include <QtCore/qmetaobject.h>
+#include <QtCore/qthreadpool.h>
+#include <QtGui/qpainterpath.h>
+#include <QtGui/private/qdistancefield_p.h>
+
+#include <algorithm>
+#include <atomic>
+
+QT_BEGIN_NAMESPACE
+
+DistanceFieldBatchGenerator::DistanceFieldBatchGenerator()
+{
+    // Problems in the cmap table are not fatal, the glyphs can still be
+    // generated. An invalid font is reported through loadFont() instead.
+    QObject::connect(&m_worker, &DistanceFieldModelWorker::error,
+                     &m_worker, [this](const QString &errorString) {
+        if (m_worker.font().isValid())
+            qWarning().noquote() << errorString;
+    });
+}
+
+void DistanceFieldBatchGenerator::setCacheDirectory(const QString &directory)
+{
+    m_worker.setCacheDirectory(directory);
+}
+
+bool DistanceFieldBatchGenerator::loadFont(const QString &fileName)
+{
+    m_fontFile = fileName;
+    m_selection.clear();
+    m_glyphs.clear();
+
+    m_worker.loadFont(fileName);
+    if (!m_worker.font().isValid()) {
+        m_errorString = tr("File '%1' is not a valid font file.").arg(fileName);
+        return false;
+    }
+
+    return true;
+}
+
+bool DistanceFieldBatchGenerator::parseRanges(const QString &ranges,
+                                              bool hexadecimal,
+                                              QList<Range> *result)
+{
+    const auto parseValue = [hexadecimal](QStringView value, bool *ok) {
+        value = value.trimmed();
+        if (hexadecimal && value.startsWith(u"U+", Qt::CaseInsensitive))
+            value = value.sliced(2);
+        return value.toUInt(ok, hexadecimal ? 16 : 10);
+    };
+
+    const QList<QStringView> parts = QStringView(ranges).split(u',', Qt::SkipEmptyParts);
+    for (QStringView part : parts) {
+        const qsizetype dash = part.indexOf(u'-');
+        bool firstOk = false;
+        bool lastOk = false;
+        const quint32 first = parseValue(dash < 0 ? part : part.first(dash), &firstOk);
+        const quint32 last = dash < 0
+                ? first
+                : parseValue(part.sliced(dash + 1), &lastOk);
+        if (!firstOk || (dash >= 0 && !lastOk) || last < first)
+            return false;
+        result->append({ first, last });
+    }
+
+    return !result->isEmpty();
+}
+
+bool DistanceFieldBatchGenerator::selectGlyphs(const QString &ranges)
+{
+    QList<Range> glyphRanges;
+    if (!parseRanges(ranges, false, &glyphRanges)) {
+        m_errorString = tr("Invalid glyph selection '%1'.").arg(ranges);
+        return false;
+    }
+
+    const quint16 glyphCount = m_worker.glyphCount();
+    for (const Range &range : std::as_const(glyphRanges)) {
+        if (range.second >= glyphCount) {
+            m_errorString = tr("Glyph index %1 is out of range. The font has %2 glyphs.")
+                    .arg(range.second).arg(glyphCount);
+            return false;
+        }
+
+        for (quint32 glyphIndex = range.first; glyphIndex <= range.second; ++glyphIndex)
+            m_selection.append(glyph_t(glyphIndex));
+    }
+
+    return true;
+}
+
+void DistanceFieldBatchGenerator::selectCharacters(const QList<Range> &ranges)
+{
+    // Ranges may cover most of Unicode, so look the characters up in chunks
+    static constexpr qsizetype maxChunkSize = 4096;
+
+    QString chunk;
+    chunk.reserve(maxChunkSize + 1);
+    const auto flush = [this, &chunk] {
+        selectString(chunk);
+        chunk.clear();
+    };
+
+    for (const Range &range : ranges) {
+        const quint32 last = qMin(range.second, quint32(QChar::LastValidCodePoint));
+        for (quint32 ucs4 = range.first; ucs4 <= last; ++ucs4) {
+            if (QChar::isSurrogate(ucs4))
+                continue;
+            chunk += QChar::fromUcs4(ucs4);
+            if (chunk.size() >= maxChunkSize)
+                flush();
+        }
+    }
+    flush();
+}
+
+bool DistanceFieldBatchGenerator::selectCharacters(const QString &ranges)
+{
+    QList<Range> characterRanges;
+    if (!parseRanges(ranges, true, &characterRanges)) {
+        m_errorString = tr("Invalid character selection '%1'.").arg(ranges);
+        return false;
+    }
+
+    selectCharacters(characterRanges);
+    return true;
+}
+
+bool DistanceFieldBatchGenerator::selectUnicodeRange(const QString &name)
+{
+    const QMetaEnum rangeEnum = QMetaEnum::fromType<DistanceFieldModel::UnicodeRange>();
+    for (int i = 0; i < rangeEnum.keyCount() - 1; ++i) {
+        // Other is not a range, but everything outside of the named ones
+        if (rangeEnum.value(i) == DistanceFieldModel::Other)
+            continue;
+        if (name.compare(QLatin1StringView(rangeEnum.key(i)), Qt::CaseInsensitive) == 0) {
+            selectCharacters({ Range(rangeEnum.value(i), rangeEnum.value(i + 1) - 1) });
+            return true;
+        }
+    }
+
+    m_errorString = tr("Unknown Unicode range '%1'.").arg(name);
+    return false;
+}
+
+void DistanceFieldBatchGenerator::selectString(const QString &string)
+{
+    const QList<quint32> glyphIndexes = m_worker.font().glyphIndexesForString(string);
+    for (quint32 glyphIndex : glyphIndexes) {
+        // Characters the font does not support map to glyph 0
+        if (glyphIndex != 0)
+            m_selection.append(glyph_t(glyphIndex));
+    }
+}
+
+void DistanceFieldBatchGenerator::selectAll()
+{
+    const quint16 glyphCount = m_worker.glyphCount();
+    m_selection.reserve(m_selection.size() + glyphCount);
+    for (quint16 glyphIndex = 0; glyphIndex < glyphCount; ++glyphIndex)
+        m_selection.append(glyph_t(glyphIndex));
+}
+
+template <typename Function>
+static void runInParallel(QThreadPool *pool, qsizetype count, Function function)
+{
+    std::atomic<qsizetype> next = 0;
+    for (int i = 0; i < pool->maxThreadCount(); ++i) {
+        pool->start([&] {
+            for (qsizetype j = next++; j < count; j = next++)
+                function(j);
+        });
+    }
+    pool->waitForDone();
+}
+
+void DistanceFieldBatchGenerator::generate(int threadCount)
+{
+    std::sort(m_selection.begin(), m_selection.end());
+    m_selection.erase(std::unique(m_selection.begin(), m_selection.end()), m_selection.end());
+
+    QThreadPool pool;
+    if (threadCount > 0)
+        pool.setMaxThreadCount(threadCount);
+
+    const bool doubleGlyphResolution = m_worker.doubleGlyphResolution();
+    const DistanceFieldCache &cache = m_worker.cache();
+
+    m_glyphs.resize(m_selection.size());
+    DistanceFieldFontWriter::Glyph *glyphs = m_glyphs.data();
+    const glyph_t *selection = m_selection.constData();
+
+    QList<bool> cached(m_selection.size(), false);
+    bool *isCached = cached.data();
+    runInParallel(&pool, m_selection.size(), [&](qsizetype i) {
+        glyphs[i].glyphIndex = selection[i];
+        isCached[i] = cache.loadGlyph(selection[i], doubleGlyphResolution,
+                                      &glyphs[i].boundingRect, &glyphs[i].distanceField);
+    });
+
+    // QRawFont must not be used from several threads at once, so the outlines
+    // are extracted up front and only the rendering is done in parallel.
+    const QRawFont font = m_worker.font();
+    QList<qsizetype> missing;
+    QList<QPainterPath> paths;
+    for (qsizetype i = 0; i < m_selection.size(); ++i) {
+        if (!cached.at(i)) {
+            missing.append(i);
+            paths.append(font.pathForGlyph(selection[i]));
+        }
+    }
+
+    const qsizetype *missingIndexes = missing.constData();
+    const QPainterPath *missingPaths = paths.constData();
+    runInParallel(&pool, missing.size(), [&](qsizetype i) {
+        DistanceFieldFontWriter::Glyph &glyph = glyphs[missingIndexes[i]];
+        QDistanceField distanceField(missingPaths[i], glyph.glyphIndex, doubleGlyphResolution);
+        glyph.boundingRect = missingPaths[i].boundingRect();
+        glyph.distanceField = distanceField.toImage(QImage::Format_Alpha8);
+        cache.saveGlyph(glyph.glyphIndex, doubleGlyphResolution,
+                        glyph.boundingRect, glyph.distanceField);
+    });
+}
+
+bool DistanceFieldBatchGenerator::save(const QString &fileName, quint32 maximumTextureSize)
+{
+    DistanceFieldFontWriter writer(m_worker.font().pixelSize(),
+                                   m_worker.doubleGlyphResolution(),
+                                   maximumTextureSize);
+    if (!writer.write(m_fontFile, fileName, m_glyphs)) {
+        m_errorString = writer.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,55 @@
+// Copyright (C) 2018 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#ifndef DISTANCEFIELDBATCHGENERATOR_H
+#define DISTANCEFIELDBATCHGENERATOR_H
+
+#include "distancefieldfontwriter.h"
+#include "distancefieldmodelworker.h"
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qlist.h>
+
+QT_BEGIN_NAMESPACE
+
+// Generates the distance fields for a selection of glyphs without any user
+// interface, spreading the work over all available cores.
+class DistanceFieldBatchGenerator
+{
+    Q_DECLARE_TR_FUNCTIONS(DistanceFieldBatchGenerator)
+    Q_DISABLE_COPY_MOVE(DistanceFieldBatchGenerator)
+public:
+    DistanceFieldBatchGenerator();
+
+    void setCacheDirectory(const QString &directory);
+    bool loadFont(const QString &fileName);
+
+    bool selectGlyphs(const QString &ranges);
+    bool selectCharacters(const QString &ranges);
+    bool selectUnicodeRange(const QString &name);
+    void selectString(const QString &string);
+    void selectAll();
+
+    qsizetype selectedGlyphCount() const { return m_selection.size(); }
+
+    void generate(int threadCount = -1);
+    bool save(const QString &fileName, quint32 maximumTextureSize);
+
+    QString errorString() const { return m_errorString; }
+
+private:
+    using Range = std::pair<quint32, quint32>;
+
+    static bool parseRanges(const QString &ranges, bool hexadecimal, QList<Range> *result);
+    void selectCharacters(const QList<Range> &ranges);
+
+    QString m_fontFile;
+    DistanceFieldModelWorker m_worker;
+    QList<glyph_t> m_selection;
+    QList<DistanceFieldFontWriter::Glyph> m_glyphs;
+    QString m_errorString;
+};
+
+QT_END_NAMESPACE
+
+#endif // DISTANCEFIELDBATCHGENERATOR_H
@@ -0,0 +1,206 @@
+// Copyright (C) 2018 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include "distancefieldcache.h"
+
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qdatastream.h>
+#include <QtCore/qdatetime.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qsavefile.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+static const quint32 CacheMagic = 0x51746466; // 'Qtdf'
+static const quint32 CacheVersion = 1;
+
+// Fonts beyond this number are removed from the cache, least recently used first
+static const int MaxCachedFonts = 16;
+
+static bool readCacheHeader(QDataStream &stream)
+{
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    return stream.status() == QDataStream::Ok && magic == CacheMagic && version == CacheVersion;
+}
+
+static void writeCacheHeader(QDataStream &stream)
+{
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << CacheMagic << CacheVersion;
+}
+
+// The modification time of font.info tells when a font was last used
+static QDateTime lastUsed(const QFileInfo &fontDirectory)
+{
+    const QFileInfo fontInfo(fontDirectory.filePath() + QLatin1StringView("/font.info"));
+    return fontInfo.exists() ? fontInfo.lastModified() : fontDirectory.lastModified();
+}
+
+static void pruneDirectory(const QString &directory)
+{
+    QFileInfoList fontDirectories = QDir(directory).entryInfoList(QDir::Dirs
+                                                                  | QDir::NoDotAndDotDot);
+    if (fontDirectories.size() <= MaxCachedFonts)
+        return;
+
+    std::sort(fontDirectories.begin(), fontDirectories.end(),
+              [](const QFileInfo &a, const QFileInfo &b) { return lastUsed(a) > lastUsed(b); });
+    for (qsizetype i = MaxCachedFonts; i < fontDirectories.size(); ++i)
+        QDir(fontDirectories.at(i).filePath()).removeRecursively();
+}
+
+void DistanceFieldCache::setDirectory(const QString &directory)
+{
+    m_directory = directory;
+    m_fontDirectory.clear();
+    if (!m_directory.isEmpty())
+        pruneDirectory(m_directory);
+}
+
+bool DistanceFieldCache::setFont(const QString &fileName)
+{
+    m_fontDirectory.clear();
+    if (m_directory.isEmpty())
+        return false;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    // The distance fields depend on the Qt version that rendered them, so
+    // that is part of the key as well.
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArrayView(QT_VERSION_STR));
+    hash.addData(QByteArrayView(reinterpret_cast<const char *>(&CacheVersion), sizeof(CacheVersion)));
+    if (!hash.addData(&file))
+        return false;
+
+    const QString fontDirectory = m_directory + u'/'
+            + QString::fromLatin1(hash.result().toHex());
+    QDir dir;
+    if (!dir.mkpath(fontDirectory + QLatin1StringView("/single"))
+            || !dir.mkpath(fontDirectory + QLatin1StringView("/double"))) {
+        return false;
+    }
+
+    QFile fontInfo(fontDirectory + QLatin1StringView("/font.info"));
+    if (fontInfo.open(QIODevice::ReadOnly))
+        fontInfo.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+
+    m_fontDirectory = fontDirectory;
+    return true;
+}
+
+bool DistanceFieldCache::loadFontInfo(FontInfo *fontInfo) const
+{
+    if (!isEnabled())
+        return false;
+
+    QFile file(m_fontDirectory + QLatin1StringView("/font.info"));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    if (!readCacheHeader(stream))
+        return false;
+
+    FontInfo info;
+    stream >> info.glyphCount >> info.doubleGlyphResolution >> info.cmapping;
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    *fontInfo = std::move(info);
+    return true;
+}
+
+void DistanceFieldCache::saveFontInfo(const FontInfo &fontInfo) const
+{
+    if (!isEnabled())
+        return;
+
+    QSaveFile file(m_fontDirectory + QLatin1StringView("/font.info"));
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    QDataStream stream(&file);
+    writeCacheHeader(stream);
+    stream << fontInfo.glyphCount << fontInfo.doubleGlyphResolution << fontInfo.cmapping;
+    if (stream.status() == QDataStream::Ok)
+        file.commit();
+}
+
+QString DistanceFieldCache::glyphFileName(glyph_t glyphIndex, bool doubleGlyphResolution) const
+{
+    return m_fontDirectory
+            + (doubleGlyphResolution ? QLatin1StringView("/double/") : QLatin1StringView("/single/"))
+            + QString::number(glyphIndex);
+}
+
+bool DistanceFieldCache::loadGlyph(glyph_t glyphIndex, bool doubleGlyphResolution,
+                                   QRectF *boundingRect, QImage *distanceField) const
+{
+    if (!isEnabled())
+        return false;
+
+    QFile file(glyphFileName(glyphIndex, doubleGlyphResolution));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    if (!readCacheHeader(stream))
+        return false;
+
+    QRectF rect;
+    qint32 width = 0;
+    qint32 height = 0;
+    stream >> rect >> width >> height;
+    if (stream.status() != QDataStream::Ok || width < 0 || height < 0
+            || qint64(width) * height != file.size() - file.pos()) {
+        return false;
+    }
+
+    // Stored without padding, as QImage's own serialization would go through PNG
+    QImage image(width, height, QImage::Format_Alpha8);
+    for (int y = 0; y < height; ++y) {
+        if (stream.readRawData(reinterpret_cast<char *>(image.scanLine(y)), width) != width)
+            return false;
+    }
+
+    *boundingRect = rect;
+    *distanceField = image;
+    return true;
+}
+
+void DistanceFieldCache::saveGlyph(glyph_t glyphIndex, bool doubleGlyphResolution,
+                                   const QRectF &boundingRect, const QImage &distanceField) const
+{
+    if (!isEnabled())
+        return;
+
+    Q_ASSERT(distanceField.format() == QImage::Format_Alpha8);
+
+    QSaveFile file(glyphFileName(glyphIndex, doubleGlyphResolution));
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    QDataStream stream(&file);
+    writeCacheHeader(stream);
+    stream << boundingRect << qint32(distanceField.width()) << qint32(distanceField.height());
+    for (int y = 0; y < distanceField.height(); ++y) {
+        stream.writeRawData(reinterpret_cast<const char *>(distanceField.constScanLine(y)),
+                            distanceField.width());
+    }
+
+    if (stream.status() == QDataStream::Ok)
+        file.commit();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,52 @@
+// Copyright (C) 2018 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#ifndef DISTANCEFIELDCACHE_H
+#define DISTANCEFIELDCACHE_H
+
+#include <QtCore/qhash.h>
+#include <QtCore/qrect.h>
+#include <QtCore/qstring.h>
+#include <QtGui/qimage.h>
+#include <QtGui/private/qtextengine_p.h>
+
+QT_BEGIN_NAMESPACE
+
+// On-disk cache of the parsed font tables and the generated distance fields,
+// keyed by the contents of the font file. Each glyph is stored in a file of
+// its own, so glyphs can be loaded and saved from several threads at once.
+// Only the most recently used fonts are kept when the directory is set.
+class DistanceFieldCache
+{
+public:
+    struct FontInfo
+    {
+        quint16 glyphCount = 0;
+        bool doubleGlyphResolution = false;
+        QHash<glyph_t, quint32> cmapping;
+    };
+
+    void setDirectory(const QString &directory);
+    QString directory() const { return m_directory; }
+
+    bool setFont(const QString &fileName);
+    bool isEnabled() const { return !m_fontDirectory.isEmpty(); }
+
+    bool loadFontInfo(FontInfo *fontInfo) const;
+    void saveFontInfo(const FontInfo &fontInfo) const;
+
+    bool loadGlyph(glyph_t glyphIndex, bool doubleGlyphResolution,
+                   QRectF *boundingRect, QImage *distanceField) const;
+    void saveGlyph(glyph_t glyphIndex, bool doubleGlyphResolution,
+                   const QRectF &boundingRect, const QImage &distanceField) const;
+
+private:
+    QString glyphFileName(glyph_t glyphIndex, bool doubleGlyphResolution) const;
+
+    QString m_directory;
+    QString m_fontDirectory;
+};
+
+QT_END_NAMESPACE
+
+#endif // DISTANCEFIELDCACHE_H
@@ -0,0 +1,45 @@
+// Copyright (C) 2018 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#ifndef DISTANCEFIELDFONTWRITER_H
+#define DISTANCEFIELDFONTWRITER_H
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qrect.h>
+#include <QtGui/qimage.h>
+#include <QtGui/private/qtextengine_p.h>
+
+QT_BEGIN_NAMESPACE
+
+// Writes a copy of a font file with an added 'qtdf' table holding the
+// pregenerated distance fields. Does not depend on any widgets, so it is
+// shared by the user interface and the command line mode.
+class DistanceFieldFontWriter
+{
+    Q_DECLARE_TR_FUNCTIONS(DistanceFieldFontWriter)
+public:
+    struct Glyph
+    {
+        glyph_t glyphIndex = 0;
+        QRectF boundingRect;
+        QImage distanceField;
+    };
+
+    DistanceFieldFontWriter(qreal pixelSize, bool doubleGlyphResolution, quint32 maximumTextureSize);
+
+    bool write(const QString &fontFileName, const QString &fileName, const QList<Glyph> &glyphs);
+    QByteArray createSfntTable(const QList<Glyph> &glyphs);
+
+    QString errorString() const { return m_errorString; }
+
+private:
+    qreal m_pixelSize;
+    bool m_doubleGlyphResolution;
+    quint32 m_maximumTextureSize;
+    QString m_errorString;
+};
+
+QT_END_NAMESPACE
+
+#endif // DISTANCEFIELDFONTWRITER_H
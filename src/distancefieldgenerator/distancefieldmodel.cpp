@@ -93,6 +93,13 @@ void DistanceFieldModel::setFont(const QString &fileName)
                               Qt::QueuedConnection);
 }
 
+void DistanceFieldModel::setCacheDirectory(const QString &directory)
+{
+    QMetaObject::invokeMethod(m_worker,
+                              [this, directory] { m_worker->setCacheDirectory(directory); },
+                              Qt::QueuedConnection);
+}
+
 void DistanceFieldModel::reserveSpace(quint16 glyphCount,
                                       bool doubleResolution,
                                       qreal pixelSize)
@@ -100,6 +107,7 @@ void DistanceFieldModel::reserveSpace(quint16 glyphCount,
     beginResetModel();
     m_glyphsPerUnicodeRange.clear();
     m_distanceFields.clear();
+    m_boundingRects.clear();
     m_glyphCount = glyphCount;
     if (glyphCount > 0)
         m_distanceFields.reserve(glyphCount);
@@ -145,16 +153,16 @@ QString DistanceFieldModel::nameForUnicodeRange(UnicodeRange range) const
 }
 
 void DistanceFieldModel::addDistanceField(const QImage &distanceField,
-                                          const QPainterPath &path,
+                                          const QRectF &boundingRect,
                                           glyph_t glyphId,
                                           quint32 ucs4)
 {
     if (glyphId >= quint16(m_distanceFields.size()))
         m_distanceFields.resize(glyphId + 1);
     m_distanceFields[glyphId] = distanceField;
-    if (glyphId >= quint16(m_paths.size()))
-        m_paths.resize(glyphId + 1);
-    m_paths[glyphId] = path;
+    if (glyphId >= quint16(m_boundingRects.size()))
+        m_boundingRects.resize(glyphId + 1);
+    m_boundingRects[glyphId] = boundingRect;
 
     if (ucs4 != 0) {
         UnicodeRange range = unicodeRangeForUcs4(ucs4);
@@ -6,7 +6,7 @@
 
 #include <QAbstractListModel>
 #include <QRawFont>
-#include <QtGui/qpainterpath.h>
+#include <QRectF>
 #include <QtGui/private/qtextengine_p.h>
 #include <QMultiHash>
 #include <QScopedPointer>
@@ -158,6 +158,7 @@ public:
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
 
     void setFont(const QString &fileName);
+    void setCacheDirectory(const QString &directory);
 
     QList<UnicodeRange> unicodeRanges() const;
     QList<glyph_t> glyphIndexesForUnicodeRange(UnicodeRange range) const;
@@ -169,9 +170,9 @@ public:
         return m_distanceFields.at(row);
     }
 
-    QPainterPath path(int row) const
+    QRectF boundingRect(int row) const
     {
-        return m_paths.at(row);
+        return m_boundingRects.at(row);
     }
 
     qreal pixelSize() const { return m_pixelSize; }
@@ -185,7 +186,7 @@ signals:
 
 private slots:
     void addDistanceField(const QImage &distanceField,
-                          const QPainterPath &path,
+                          const QRectF &boundingRect,
                           glyph_t glyphId,
                           quint32 ucs4);
     void reserveSpace(quint16 glyphCount,
@@ -200,7 +201,7 @@ private:
     QScopedPointer<QThread> m_workerThread;
     quint16 m_glyphCount;
     QList<QImage> m_distanceFields;
-    QList<QPainterPath> m_paths;
+    QList<QRectF> m_boundingRects;
     QMultiHash<UnicodeRange, glyph_t> m_glyphsPerUnicodeRange;
     QHash<quint32, glyph_t> m_glyphsPerUcs4;
     bool m_doubleGlyphResolution;
@@ -288,14 +288,38 @@ void DistanceFieldModelWorker::readGlyphCount()
     m_doubleGlyphResolution = qt_fontHasNarrowOutlines(m_font) && m_glyphCount < QT_DISTANCEFIELD_HIGHGLYPHCOUNT();
 }
 
+void DistanceFieldModelWorker::setCacheDirectory(const QString &directory)
+{
+    m_cache.setDirectory(directory);
+}
+
 void DistanceFieldModelWorker::loadFont(const QString &fileName)
 {
     m_font = QRawFont(fileName, 64);
     if (!m_font.isValid())
         emit error(tr("File '%1' is not a valid font file.").arg(fileName));
 
-    readGlyphCount();
-    readCmap();
+    m_cmapping.clear();
+
+    DistanceFieldCache::FontInfo fontInfo;
+    if (m_font.isValid() && m_cache.setFont(fileName) && m_cache.loadFontInfo(&fontInfo)) {
+        m_nextGlyphId = 0;
+        m_glyphCount = fontInfo.glyphCount;
+        m_doubleGlyphResolution = fontInfo.doubleGlyphResolution;
+        m_cmapping = std::move(fontInfo.cmapping);
+    } else {
+        // Only cache tables that could be read without problems, so errors
+        // are reported again the next time the font is loaded
+        bool hasErrors = false;
+        QMetaObject::Connection connection = connect(this, &DistanceFieldModelWorker::error,
+                                                     this, [&hasErrors] { hasErrors = true; });
+        readGlyphCount();
+        readCmap();
+        disconnect(connection);
+
+        if (!hasErrors)
+            m_cache.saveFontInfo({ m_glyphCount, m_doubleGlyphResolution, m_cmapping });
+    }
 
     qreal pixelSize = QT_DISTANCEFIELD_BASEFONTSIZE(m_doubleGlyphResolution) * QT_DISTANCEFIELD_SCALE(m_doubleGlyphResolution);
     m_font.setPixelSize(pixelSize);
@@ -314,10 +338,18 @@ void DistanceFieldModelWorker::generateOneDistanceField()
         return;
     }
 
-    QPainterPath path = m_font.pathForGlyph(m_nextGlyphId);
-    QDistanceField distanceField(path, m_nextGlyphId, m_doubleGlyphResolution);
-    emit distanceFieldGenerated(distanceField.toImage(QImage::Format_Alpha8),
-                                path,
+    QRectF boundingRect;
+    QImage image;
+    if (!m_cache.loadGlyph(m_nextGlyphId, m_doubleGlyphResolution, &boundingRect, &image)) {
+        QPainterPath path = m_font.pathForGlyph(m_nextGlyphId);
+        QDistanceField distanceField(path, m_nextGlyphId, m_doubleGlyphResolution);
+        boundingRect = path.boundingRect();
+        image = distanceField.toImage(QImage::Format_Alpha8);
+        m_cache.saveGlyph(m_nextGlyphId, m_doubleGlyphResolution, boundingRect, image);
+    }
+
+    emit distanceFieldGenerated(image,
+                                boundingRect,
                                 m_nextGlyphId,
                                 m_cmapping.value(m_nextGlyphId));
 
@@ -4,6 +4,8 @@
 #ifndef DISTANCEFIELDMODELWORKER_H
 #define DISTANCEFIELDMODELWORKER_H
 
+#include "distancefieldcache.h"
+
 #include <QObject>
 #include <QRawFont>
 #include <QtGui/private/qtextengine_p.h>
@@ -23,6 +25,7 @@ public:
 
     Q_INVOKABLE void generateOneDistanceField();
     Q_INVOKABLE void loadFont(const QString &fileName);
+    Q_INVOKABLE void setCacheDirectory(const QString &directory);
 
     void readCmapSubtable(const CmapSubtable0 *subtable, const void *end);
     void readCmapSubtable(const CmapSubtable4 *subtable, const void *end);
@@ -30,11 +33,16 @@ public:
     void readCmapSubtable(const CmapSubtable10 *subtable, const void *end);
     void readCmapSubtable(const CmapSubtable12 *subtable, const void *end);
 
+    QRawFont font() const { return m_font; }
+    quint16 glyphCount() const { return m_glyphCount; }
+    bool doubleGlyphResolution() const { return m_doubleGlyphResolution; }
+    const DistanceFieldCache &cache() const { return m_cache; }
+
 signals:
     void fontLoaded(quint16 glyphCount, bool doubleResolution, qreal pixelSize);
     void fontGenerated();
     void distanceFieldGenerated(const QImage &distanceField,
-                                const QPainterPath &path,
+                                const QRectF &boundingRect,
                                 glyph_t glyphId,
                                 quint32 cmapAssignment);
     void error(const QString &errorString);
@@ -48,6 +56,7 @@ private:
     quint16 m_nextGlyphId;
     bool m_doubleGlyphResolution;
     QHash<glyph_t, quint32> m_cmapping;
+    DistanceFieldCache m_cache;
 };
 
 QT_END_NAMESPACE
@@ -2,34 +2,173 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
 
 #include "mainwindow.h"
+#include "distancefieldbatchgenerator.h"
 
 #include <QApplication>
 #include <QCommandLineParser>
 
+#include <memory>
+
 QT_USE_NAMESPACE
 
+static bool isBatchMode(int argc, char **argv)
+{
+    for (int i = 1; i < argc; ++i) {
+        const QByteArrayView argument(argv[i]);
+        if (argument == "-o" || argument == "--output" || argument.startsWith("--output="))
+            return true;
+    }
+    return false;
+}
+
+static int runBatch(const QCommandLineParser &parser)
+{
+    const auto fail = [](const QString &message) {
+        fprintf(stderr, "%s\n", qPrintable(message));
+        return 1;
+    };
+
+    const QStringList positionalArguments = parser.positionalArguments();
+    if (positionalArguments.size() != 1)
+        return fail(QCoreApplication::translate("main", "Exactly one font file must be given."));
+
+    bool ok = false;
+    const uint textureSize = parser.value(QStringLiteral("texture-size")).toUInt(&ok);
+    if (!ok || textureSize < 64)
+        return fail(QCoreApplication::translate("main", "Invalid texture size '%1'.")
+                    .arg(parser.value(QStringLiteral("texture-size"))));
+
+    int jobs = -1;
+    if (parser.isSet(QStringLiteral("jobs"))) {
+        jobs = parser.value(QStringLiteral("jobs")).toInt(&ok);
+        if (!ok || jobs < 1)
+            return fail(QCoreApplication::translate("main", "Invalid number of jobs '%1'.")
+                        .arg(parser.value(QStringLiteral("jobs"))));
+    }
+
+    DistanceFieldBatchGenerator generator;
+    if (parser.isSet(QStringLiteral("cache")))
+        generator.setCacheDirectory(parser.value(QStringLiteral("cache")));
+    if (!generator.loadFont(positionalArguments.constFirst()))
+        return fail(generator.errorString());
+
+    bool hasSelection = false;
+    const QStringList glyphs = parser.values(QStringLiteral("glyphs"));
+    for (const QString &ranges : glyphs) {
+        if (!generator.selectGlyphs(ranges))
+            return fail(generator.errorString());
+        hasSelection = true;
+    }
+
+    const QStringList characters = parser.values(QStringLiteral("characters"));
+    for (const QString &ranges : characters) {
+        if (!generator.selectCharacters(ranges))
+            return fail(generator.errorString());
+        hasSelection = true;
+    }
+
+    const QStringList unicodeRanges = parser.values(QStringLiteral("unicode-range"));
+    for (const QString &name : unicodeRanges) {
+        if (!generator.selectUnicodeRange(name))
+            return fail(generator.errorString());
+        hasSelection = true;
+    }
+
+    const QStringList strings = parser.values(QStringLiteral("string"));
+    for (const QString &string : strings) {
+        generator.selectString(string);
+        hasSelection = true;
+    }
+
+    if (!hasSelection)
+        generator.selectAll();
+
+    if (generator.selectedGlyphCount() == 0)
+        return fail(QCoreApplication::translate("main", "No glyphs selected for saving."));
+
+    generator.generate(jobs);
+    if (!generator.save(parser.value(QStringLiteral("output")), textureSize))
+        return fail(generator.errorString());
+
+    return 0;
+}
+
 int main(int argc, char **argv)
 {
-    QApplication app(argc, argv);
-    app.setOrganizationName(QStringLiteral("QtProject"));
-    app.setApplicationName(QStringLiteral("Qt Distance Field Generator"));
-    app.setApplicationVersion(QStringLiteral(QT_VERSION_STR));
+    // The command line mode does not show any windows, so it should also run
+    // on machines without a display.
+    const bool batchMode = isBatchMode(argc, argv);
+    if (batchMode && !qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    std::unique_ptr<QGuiApplication> app(batchMode ? new QGuiApplication(argc, argv)
+                                                   : new QApplication(argc, argv));
+    app->setOrganizationName(QStringLiteral("QtProject"));
+    app->setApplicationName(QStringLiteral("Qt Distance Field Generator"));
+    app->setApplicationVersion(QStringLiteral(QT_VERSION_STR));
 
     QCommandLineParser parser;
     parser.setApplicationDescription(
                 QCoreApplication::translate("main",
-                                            "Allows to prepare a font cache for Qt applications."));
+                                            "Allows to prepare a font cache for Qt applications.\n\n"
+                                            "When an output file is given, the distance fields are "
+                                            "generated without showing the user interface. Without "
+                                            "any selection, all glyphs in the font are saved."));
     parser.addHelpOption();
     parser.addVersionOption();
     parser.addPositionalArgument(QLatin1String("file"),
                                  QCoreApplication::translate("main",
                                                              "Font file (*.ttf, *.otf)"));
-    parser.process(app);
+    parser.addOption({ { QStringLiteral("o"), QStringLiteral("output") },
+                       QCoreApplication::translate("main",
+                                                   "Generate the distance fields and save the "
+                                                   "font to <file> without showing the user interface."),
+                       QStringLiteral("file") });
+    parser.addOption({ QStringLiteral("glyphs"),
+                       QCoreApplication::translate("main",
+                                                   "Select glyph indexes, for instance '0-99,120'."),
+                       QStringLiteral("ranges") });
+    parser.addOption({ QStringLiteral("characters"),
+                       QCoreApplication::translate("main",
+                                                   "Select the glyphs of hexadecimal Unicode code "
+                                                   "points, for instance 'U+0020-U+007E,4E00-9FFF'."),
+                       QStringLiteral("ranges") });
+    parser.addOption({ QStringLiteral("unicode-range"),
+                       QCoreApplication::translate("main",
+                                                   "Select the glyphs of a named Unicode range, "
+                                                   "for instance 'BasicLatin'."),
+                       QStringLiteral("name") });
+    parser.addOption({ QStringLiteral("string"),
+                       QCoreApplication::translate("main",
+                                                   "Select the glyphs of the characters in <text>."),
+                       QStringLiteral("text") });
+    parser.addOption({ QStringLiteral("texture-size"),
+                       QCoreApplication::translate("main",
+                                                   "Maximum texture size (default: 2048)."),
+                       QStringLiteral("size"),
+                       QStringLiteral("2048") });
+    parser.addOption({ { QStringLiteral("j"), QStringLiteral("jobs") },
+                       QCoreApplication::translate("main",
+                                                   "Number of threads used to generate the "
+                                                   "distance fields (default: number of cores)."),
+                       QStringLiteral("count") });
+    parser.addOption({ QStringLiteral("cache"),
+                       QCoreApplication::translate("main",
+                                                   "Keep the generated distance fields in <directory>, "
+                                                   "so later runs only generate glyphs that are not "
+                                                   "in the cache yet."),
+                       QStringLiteral("directory") });
+    parser.process(*app);
+
+    if (batchMode)
+        return runBatch(parser);
 
     MainWindow mainWindow;
+    if (parser.isSet(QStringLiteral("cache")))
+        mainWindow.setCacheDirectory(parser.value(QStringLiteral("cache")));
     if (!parser.positionalArguments().isEmpty())
         mainWindow.open(parser.positionalArguments().constFirst());
     mainWindow.show();
 
-    return app.exec();
+    return app->exec();
 }
@@ -24,6 +24,7 @@ public:
     explicit MainWindow(QWidget *parent = 0);
     ~MainWindow();
 
+    void setCacheDirectory(const QString &directory);
     void open(const QString &path);
 
 protected:
@@ -47,7 +48,6 @@ private slots:
 private:
     void setupConnections();
     void writeFile();
-    QByteArray createSfntTable();
 
     Ui::MainWindow *ui;
     QString m_fontDir;
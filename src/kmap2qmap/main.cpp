@@ -1,16 +1,21 @@
 // Copyright (C) 2016 The Qt Company Ltd.
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
 
+#include <atomic>
 #include <cstdio>
 
 #include <QFile>
 #include <QFileInfo>
 #include <QDir>
+#include <QDirIterator>
+#include <QHash>
 #include <QList>
 #include <QByteArray>
 #include <QStringDecoder>
 #include <QStringList>
+#include <QScopeGuard>
 #include <QTextStream>
+#include <QThreadPool>
 
 #include <QtInputSupport/private/qevdevkeyboardhandler_p.h>
 
@@ -302,8 +307,6 @@ static const struct symbol_map_t symbol_map[] = {
     { "CtrlR",   Qt::Key_Control },
 };
 
-static const int symbol_map_size = sizeof(symbol_map)/sizeof(symbol_map_t);
-
 
 struct symbol_dead_unicode_t {
     quint32 dead;
@@ -361,7 +364,37 @@ static const symbol_synonyms_t symbol_synonyms[] = {
     { "rightanglequote", "guillemotright" },
 };
 
-static const int symbol_synonyms_size = sizeof(symbol_synonyms)/sizeof(symbol_synonyms_t);
+// The tables above are searched for every token of every keymap line, so
+// they are indexed once. Earlier entries win, as they did for a linear search.
+template <typename Entry, size_t Size, typename Key, typename Value>
+static QHash<QByteArrayView, Value> indexTable(const Entry (&table)[Size], Key Entry::*key, Value Entry::*value)
+{
+    QHash<QByteArrayView, Value> hash;
+    hash.reserve(Size);
+    for (const Entry &entry : table) {
+        if (!hash.contains(entry.*key))
+            hash.insert(entry.*key, entry.*value);
+    }
+    return hash;
+}
+
+static const QHash<QByteArrayView, quint8> &modifierLookup()
+{
+    static const auto hash = indexTable(modifier_map, &modifier_map_t::symbol, &modifier_map_t::modifier);
+    return hash;
+}
+
+static const QHash<QByteArrayView, quint32> &symbolLookup()
+{
+    static const auto hash = indexTable(symbol_map, &symbol_map_t::symbol, &symbol_map_t::qtcode);
+    return hash;
+}
+
+static const QHash<QByteArrayView, const char *> &synonymLookup()
+{
+    static const auto hash = indexTable(symbol_synonyms, &symbol_synonyms_t::from, &symbol_synonyms_t::to);
+    return hash;
+}
 
 // makes the generated array in --header mode a bit more human readable
 QT_BEGIN_NAMESPACE
@@ -397,6 +430,7 @@ private:
 
 private:
     QList<QEvdevKeyboardMap::Mapping> m_keymap;
+    QHash<quint32, qsizetype> m_keymap_index; // (keycode << 8 | modifiers) -> index in m_keymap
     QList<QEvdevKeyboardMap::Composing> m_keycompose;
 
     int m_warning_count;
@@ -404,57 +438,140 @@ private:
 
 
 
-int main(int argc, char **argv)
+enum ConvertResult {
+    ConvertOk = 0,
+    ConvertUsage = 1,
+    ConvertReadError = 2,
+    ConvertWriteError = 3,
+    ConvertParseError = 4,
+    ConvertGenerateError = 5
+};
+
+static int convert(const QStringList &kmapFiles, const QString &qmapFile, bool header, int *warningCount)
 {
-    int header = 0;
-    if (argc >= 2 && !qstrcmp(argv[1], "--header"))
-        header = 1;
+    QList<QFile *> kmaps(kmapFiles.size());
+    for (int i = 0; i < kmaps.size(); ++i)
+        kmaps[i] = new QFile(kmapFiles.at(i));
+    const auto cleanup = qScopeGuard([&kmaps] { qDeleteAll(kmaps); });
+
+    for (QFile *kmap : std::as_const(kmaps)) {
+        if (!kmap->open(QIODevice::ReadOnly)) {
+            fprintf(stderr, "Could not read from '%s'.\n", qPrintable(kmap->fileName()));
+            return ConvertReadError;
+        }
+    }
 
-    if (argc < (3 + header)) {
-        fprintf(stderr, "Usage: kmap2qmap [--header] <kmap> [<additional kmaps> ...] <qmap>\n");
-        fprintf(stderr, "  --header   can be used to generate Qt's default compiled in qmap.\n");
-        return 1;
+    QFile qmap(qmapFile);
+    if (!qmap.open(QIODevice::WriteOnly)) {
+        fprintf(stderr, "Could not write to '%s'.\n", qPrintable(qmapFile));
+        return ConvertWriteError;
     }
 
-    QList<QFile *> kmaps(argc - header - 2);
-    for (int i = 0; i < kmaps.size(); ++i) {
-        kmaps [i] = new QFile(QString::fromLocal8Bit(argv[i + 1 + header]));
+    KeymapParser p;
 
-        if (!kmaps[i]->open(QIODevice::ReadOnly)) {
-            fprintf(stderr, "Could not read from '%s'.\n", argv[i + 1 + header]);
-            return 2;
+    for (QFile *kmap : std::as_const(kmaps)) {
+        if (!p.parseKmap(kmap)) {
+            fprintf(stderr, "Parsing kmap '%s' failed.\n", qPrintable(kmap->fileName()));
+            return ConvertParseError;
         }
     }
-    QFile *qmap = new QFile(QString::fromLocal8Bit(argv[argc - 1]));
 
-    if (!qmap->open(QIODevice::WriteOnly)) {
-        fprintf(stderr, "Could not write to '%s'.\n", argv[argc - 1]);
-        return 3;
+    *warningCount = p.parseWarningCount();
+
+    if (!(header ? p.generateHeader(&qmap) : p.generateQmap(&qmap))) {
+        fprintf(stderr, "Generating the qmap '%s' failed.\n", qPrintable(qmapFile));
+        return ConvertGenerateError;
     }
 
-    KeymapParser p;
+    return ConvertOk;
+}
 
-    for (int i = 0; i < kmaps.size(); ++i) {
-        if (!p.parseKmap(kmaps[i])) {
-            fprintf(stderr, "Parsing kmap '%s' failed.\n", qPrintable(kmaps[i]->fileName()));
-            return 4;
-        }
+// Converts every .kmap file below kmapDir into a file of the same relative
+// path below qmapDir, spreading the files over all cores.
+static int convertDirectory(const QString &kmapDir, const QString &qmapDir, bool header)
+{
+    if (!QFileInfo(kmapDir).isDir()) {
+        fprintf(stderr, "Could not read from '%s'.\n", qPrintable(kmapDir));
+        return ConvertReadError;
     }
 
-    if (p.parseWarningCount()) {
-        fprintf(stderr, "\nParsing the specified keymap(s) produced %d warning(s).\n" \
-                        "Your generated qmap might not be complete.\n", \
-                        p.parseWarningCount());
+    QStringList kmapFiles;
+    QDirIterator it(kmapDir, QStringList(QStringLiteral("*.kmap")), QDir::Files,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext())
+        kmapFiles.append(it.next());
+    kmapFiles.sort();
+
+    if (kmapFiles.isEmpty()) {
+        fprintf(stderr, "No kmap files found in '%s'.\n", qPrintable(kmapDir));
+        return ConvertReadError;
     }
-    if (!(header ? p.generateHeader(qmap) : p.generateQmap(qmap))) {
-        fprintf(stderr, "Generating the qmap failed.\n");
-        return 5;
+
+    const QDir inputDir(kmapDir);
+    const QDir outputDir(qmapDir);
+    const QString suffix = header ? QStringLiteral(".h") : QStringLiteral(".qmap");
+    std::atomic<int> result = ConvertOk;
+
+    QThreadPool pool;
+    for (const QString &kmapFile : std::as_const(kmapFiles)) {
+        pool.start([&, kmapFile] {
+            QString relativePath = inputDir.relativeFilePath(kmapFile);
+            relativePath.chop(5); // ".kmap"
+            const QString qmapFile = outputDir.filePath(relativePath + suffix);
+
+            if (!QDir().mkpath(QFileInfo(qmapFile).absolutePath())) {
+                fprintf(stderr, "Could not write to '%s'.\n", qPrintable(qmapFile));
+                result = ConvertWriteError;
+                return;
+            }
+
+            int warningCount = 0;
+            const int status = convert(QStringList(kmapFile), qmapFile, header, &warningCount);
+            if (status != ConvertOk) {
+                result = status;
+            } else if (warningCount) {
+                fprintf(stderr, "Parsing '%s' produced %d warning(s).\n",
+                        qPrintable(kmapFile), warningCount);
+            }
+        });
+    }
+    pool.waitForDone();
+
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    int header = 0;
+    if (argc >= 2 && !qstrcmp(argv[1], "--header"))
+        header = 1;
+
+    if (argc == 4 + header && !qstrcmp(argv[1 + header], "--directory")) {
+        return convertDirectory(QString::fromLocal8Bit(argv[2 + header]),
+                                QString::fromLocal8Bit(argv[3 + header]), header);
+    }
+
+    if (argc < (3 + header)) {
+        fprintf(stderr, "Usage: kmap2qmap [--header] <kmap> [<additional kmaps> ...] <qmap>\n");
+        fprintf(stderr, "       kmap2qmap [--header] --directory <kmap dir> <qmap dir>\n");
+        fprintf(stderr, "  --header      can be used to generate Qt's default compiled in qmap.\n");
+        fprintf(stderr, "  --directory   converts all .kmap files below <kmap dir> in parallel.\n");
+        return ConvertUsage;
     }
 
-    qDeleteAll(kmaps);
-    delete qmap;
+    QStringList kmapFiles;
+    for (int i = 1 + header; i < argc - 1; ++i)
+        kmapFiles.append(QString::fromLocal8Bit(argv[i]));
 
-    return 0;
+    int warningCount = 0;
+    const int status = convert(kmapFiles, QString::fromLocal8Bit(argv[argc - 1]), header,
+                               &warningCount);
+    if (warningCount) {
+        fprintf(stderr, "\nParsing the specified keymap(s) produced %d warning(s).\n" \
+                        "Your generated qmap might not be complete.\n", \
+                        warningCount);
+    }
+    return status;
 }
 
 
@@ -756,6 +873,9 @@ bool KeymapParser::parseKmap(QFile *f)
         }
     }
     std::sort(m_keymap.begin(), m_keymap.end());
+    m_keymap_index.clear();
+    for (qsizetype i = 0; i < m_keymap.size(); ++i)
+        m_keymap_index.insert(quint32(m_keymap.at(i).keycode) << 8 | m_keymap.at(i).modifiers, i);
     return !m_keymap.isEmpty();
 }
 
@@ -763,18 +883,18 @@ bool KeymapParser::parseKmap(QFile *f)
 
 void KeymapParser::updateMapping(quint16 keycode, quint8 modifiers, quint16 unicode, quint32 qtcode, quint8 flags, quint16 special)
 {
-    for (int i = 0; i < m_keymap.size(); ++i) {
-        QEvdevKeyboardMap::Mapping &m = m_keymap[i];
-
-        if (m.keycode == keycode && m.modifiers == modifiers) {
-            m.unicode = unicode;
-            m.qtcode  = qtcode;
-            m.flags   = flags;
-            m.special = special;
-            return;
-        }
+    const quint32 key = quint32(keycode) << 8 | modifiers;
+    const auto it = m_keymap_index.constFind(key);
+    if (it != m_keymap_index.cend()) {
+        QEvdevKeyboardMap::Mapping &m = m_keymap[*it];
+        m.unicode = unicode;
+        m.qtcode  = qtcode;
+        m.flags   = flags;
+        m.special = special;
+        return;
     }
     QEvdevKeyboardMap::Mapping m = { keycode, unicode, qtcode, modifiers, flags, special };
+    m_keymap_index.insert(key, m_keymap.size());
     m_keymap << m;
 }
 
@@ -793,15 +913,14 @@ quint32 KeymapParser::toQtModifiers(quint8 modifiers)
 
 bool KeymapParser::parseModifier(const QByteArray &str, quint8 &modifier)
 {
-    QByteArray lstr = str.toLower();
+    const QByteArray lstr = str.toLower();
 
-    for (int i = 0; i < modifier_map_size; ++i) {
-        if (lstr == modifier_map[i].symbol) {
-            modifier = modifier_map[i].modifier;
-            return true;
-        }
-    }
-    return false;
+    const auto &lookup = modifierLookup();
+    const auto it = lookup.constFind(lstr);
+    if (it == lookup.cend())
+        return false;
+    modifier = *it;
+    return true;
 }
 
 
@@ -852,12 +971,8 @@ bool KeymapParser::parseSymbol(const QByteArray &str, quint16 &unicode, quint32
         if (!ok)
             return false;
     } else { // symbolic
-        for (int i = 0; i < symbol_synonyms_size; ++i) {
-            if (sym == symbol_synonyms[i].from) {
-                sym = symbol_synonyms[i].to;
-                break;
-            }
-        }
+        if (const char *synonym = synonymLookup().value(sym, nullptr))
+            sym = synonym;
 
         quint32 qtmod = 0;
 
@@ -887,12 +1002,7 @@ bool KeymapParser::parseSymbol(const QByteArray &str, quint16 &unicode, quint32
             }
 
             // map symbol to Qt key code
-            for  (int i = 0; i < symbol_map_size; ++i) {
-                if (sym == symbol_map[i].symbol) {
-                    qtcode = symbol_map[i].qtcode;
-                    break;
-                }
-            }
+            qtcode = symbolLookup().value(sym, Qt::Key_unknown);
 
             // a-zA-Z is not in the table to save space
             if (qtcode == Qt::Key_unknown && sym.length() == 1) {
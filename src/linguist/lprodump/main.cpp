@@ -14,15 +14,24 @@
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
 #include <QtCore/QLibraryInfo>
+#include <QtCore/QMutex>
 #include <QtCore/QRegularExpression>
+#include <QtCore/QRunnable>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSemaphore>
 #include <QtCore/QString>
 #include <QtCore/QStringList>
+#include <QtCore/QThreadPool>
 
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <vector>
 
 using namespace Qt::StringLiterals;
 
@@ -33,6 +42,9 @@ static void printOut(const QString &out)
 
 static void printErr(const QString &out)
 {
+    // Projects are evaluated concurrently
+    static QMutex mutex;
+    QMutexLocker locker(&mutex);
     std::cerr << qPrintable(out);
 }
 
@@ -76,8 +88,15 @@ Options:
            Virtual output directory for processing subsequent .pro files.
     -pro-debug
            Trace processing .pro files. Specify twice for more verbosity.
+    -pro-cache <directory>
+           Cache parsed .pro/.pri/.prf files in the given directory to
+           speed up subsequent runs.
     -out <filename>
            Name of the output file.
+    -dependencies-out <filename>
+           Name of a file listing the files and directories that were looked
+           at, with their content hashes or time stamps. lupdate-pro and
+           lrelease-pro use it to skip running lprodump if nothing changed.
     -translations-variables <variable_1>[,<variable_2>,...]
            Comma-separated list of QMake variables containing .ts files.
     -version
@@ -119,6 +138,48 @@ public:
 
 static EvalHandler evalHandler;
 
+// Writes one line per file that was read (F), found (E) or found missing (M)
+// during evaluation, followed by the directories containing them or listed by
+// $$files() (D). The directory time stamps catch files added to or removed from
+// wildcard matches.
+static bool writeDependencies(const QString &filePath, QMakeVfs *vfs)
+{
+    const QHash<QString, QMakeVfs::FileState> files = vfs->accessedFiles();
+    QStringList fileNames = files.keys();
+    fileNames.sort();
+    QStringList dirs;
+    QByteArray contents;
+    for (const QString &fileName : std::as_const(fileNames)) {
+        if (fileName.startsWith(QLatin1Char(':')))
+            continue; // Built-in resource, covered by the Qt version
+        switch (files.value(fileName)) {
+        case QMakeVfs::FileRead:
+            contents += "F " + fileContentHash(fileName);
+            break;
+        case QMakeVfs::FileExists:
+            contents += "E -";
+            break;
+        case QMakeVfs::FileMissing:
+            contents += "M -";
+            break;
+        }
+        contents += ' ' + fileName.toUtf8() + '\n';
+        dirs << QFileInfo(fileName).path();
+    }
+    dirs += vfs->listedDirectories();
+    dirs.sort();
+    dirs.removeDuplicates();
+    for (const QString &dir : std::as_const(dirs))
+        contents += "D " + directoryTimeStamp(dir) + ' ' + dir.toUtf8() + '\n';
+
+    QDir().mkpath(QFileInfo(filePath).path());
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+    file.write(contents);
+    return file.commit();
+}
+
 static QStringList getResources(const QString &resourceFile, QMakeVfs *vfs)
 {
     Q_ASSERT(vfs);
@@ -231,12 +292,12 @@ static void excludeProjects(const ProFileEvaluator &visitor, QStringList *subPro
 static QJsonArray processProjects(bool topLevel, const QStringList &proFiles,
         const QStringList &translationsVariables,
         const QHash<QString, QString> &outDirMap,
-        ProFileGlobals *option, QMakeVfs *vfs, QMakeParser *parser,
+        ProFileGlobals *option, QMakeVfs *vfs, ProFileCache *cache,
         bool *fail);
 
 static QJsonObject processProject(const QString &proFile, const QStringList &translationsVariables,
                                   ProFileGlobals *option, QMakeVfs *vfs,
-                                  QMakeParser *parser, ProFileEvaluator &visitor)
+                                  ProFileCache *cache, ProFileEvaluator &visitor)
 {
     QJsonObject result;
     QStringList tmp = visitor.values(QLatin1String("CODECFORSRC"));
@@ -264,7 +325,7 @@ static QJsonObject processProject(const QString &proFile, const QStringList &tra
             }
         }
         QJsonArray subResults = processProjects(false, subProFiles, translationsVariables,
-                                                QHash<QString, QString>(), option, vfs, parser,
+                                                QHash<QString, QString>(), option, vfs, cache,
                                                 nullptr);
         if (!subResults.isEmpty())
             setValue(result, "subProjects", subResults);
@@ -278,55 +339,122 @@ static QJsonObject processProject(const QString &proFile, const QStringList &tra
     return result;
 }
 
+// Evaluates a project file. Each evaluation uses its own parser, sharing the cache
+// of parsed files, so that evaluations can run in parallel.
+static std::optional<QJsonObject> processProjectFile(bool topLevel, const QString &proFile,
+        const QStringList &translationsVariables,
+        ProFileGlobals *option, QMakeVfs *vfs, ProFileCache *cache)
+{
+    QMakeParser parser(cache, vfs, &evalHandler);
+    ProFile *pro;
+    if (!(pro = parser.parsedProFile(proFile, topLevel ? QMakeParser::ParseReportMissing
+                                                       : QMakeParser::ParseDefault))) {
+        return std::nullopt;
+    }
+    ProFileEvaluator visitor(option, &parser, vfs, &evalHandler);
+    visitor.setCumulative(true);
+    visitor.setOutputDir(option->shadowedPath(pro->directoryName()));
+    if (!visitor.accept(pro)) {
+        pro->deref();
+        return std::nullopt;
+    }
+
+    QJsonObject prj = processProject(proFile, translationsVariables, option, vfs, cache,
+                                     visitor);
+    setValue(prj, "projectFile", proFile);
+    QStringList tsFiles;
+    for (const QString &varName : translationsVariables) {
+        if (!visitor.contains(varName))
+            continue;
+        QDir proDir(QFileInfo(proFile).path());
+        const QStringList translations = visitor.values(varName);
+        for (const QString &tsFile : translations)
+            tsFiles << proDir.filePath(tsFile);
+    }
+    if (!tsFiles.isEmpty())
+        setValue(prj, "translations", tsFiles);
+    if (visitor.contains(QLatin1String("LUPDATE_COMPILE_COMMANDS_PATH"))) {
+        const QStringList thepathjson = visitor.values(
+            QLatin1String("LUPDATE_COMPILE_COMMANDS_PATH"));
+        setValue(prj, "compileCommands", thepathjson.value(0));
+    }
+    pro->deref();
+    return prj;
+}
+
+// Project evaluation queued on the global thread pool
+class ProjectTask : public QRunnable
+{
+public:
+    explicit ProjectTask(std::function<std::optional<QJsonObject>()> evaluate)
+        : m_evaluate(std::move(evaluate))
+    {
+        setAutoDelete(false);
+    }
+
+    void run() override
+    {
+        m_result = m_evaluate();
+        m_done.release();
+    }
+
+    // Returns the result, evaluating the project in the calling thread if no
+    // worker has picked it up yet. This cannot dead-lock on nested SUBDIRS.
+    std::optional<QJsonObject> takeResult()
+    {
+        QThreadPool *pool = QThreadPool::globalInstance();
+        if (pool->tryTake(this)) {
+            run();
+        } else {
+            pool->releaseThread();
+            m_done.acquire();
+            pool->reserveThread();
+        }
+        return std::move(m_result);
+    }
+
+private:
+    std::function<std::optional<QJsonObject>()> m_evaluate;
+    std::optional<QJsonObject> m_result;
+    QSemaphore m_done;
+};
+
 static QJsonArray processProjects(bool topLevel, const QStringList &proFiles,
         const QStringList &translationsVariables,
         const QHash<QString, QString> &outDirMap,
-        ProFileGlobals *option, QMakeVfs *vfs, QMakeParser *parser, bool *fail)
+        ProFileGlobals *option, QMakeVfs *vfs, ProFileCache *cache, bool *fail)
 {
     QJsonArray result;
-    for (const QString &proFile : proFiles) {
-        if (!outDirMap.isEmpty())
-            option->setDirectories(QFileInfo(proFile).path(), outDirMap[proFile]);
-
-        ProFile *pro;
-        if (!(pro = parser->parsedProFile(proFile, topLevel ? QMakeParser::ParseReportMissing
-                                                            : QMakeParser::ParseDefault))) {
-            if (topLevel)
-                *fail = true;
-            continue;
-        }
-        ProFileEvaluator visitor(option, parser, vfs, &evalHandler);
-        visitor.setCumulative(true);
-        visitor.setOutputDir(option->shadowedPath(pro->directoryName()));
-        if (!visitor.accept(pro)) {
-            if (topLevel)
-                *fail = true;
-            pro->deref();
-            continue;
+    const auto append = [&result, topLevel, fail](const std::optional<QJsonObject> &prj) {
+        if (prj)
+            result.append(*prj);
+        else if (topLevel)
+            *fail = true;
+    };
+
+    // Changing the directories of the shared globals requires sequential evaluation
+    if (!outDirMap.isEmpty() || proFiles.size() < 2) {
+        for (const QString &proFile : proFiles) {
+            if (!outDirMap.isEmpty())
+                option->setDirectories(QFileInfo(proFile).path(), outDirMap[proFile]);
+            append(processProjectFile(topLevel, proFile, translationsVariables, option, vfs,
+                                      cache));
         }
+        return result;
+    }
 
-        QJsonObject prj = processProject(proFile, translationsVariables, option, vfs, parser,
-                                         visitor);
-        setValue(prj, "projectFile", proFile);
-        QStringList tsFiles;
-        for (const QString &varName : translationsVariables) {
-            if (!visitor.contains(varName))
-                continue;
-            QDir proDir(QFileInfo(proFile).path());
-            const QStringList translations = visitor.values(varName);
-            for (const QString &tsFile : translations)
-                tsFiles << proDir.filePath(tsFile);
-        }
-        if (!tsFiles.isEmpty())
-            setValue(prj, "translations", tsFiles);
-        if (visitor.contains(QLatin1String("LUPDATE_COMPILE_COMMANDS_PATH"))) {
-            const QStringList thepathjson = visitor.values(
-                QLatin1String("LUPDATE_COMPILE_COMMANDS_PATH"));
-            setValue(prj, "compileCommands", thepathjson.value(0));
-        }
-        result.append(prj);
-        pro->deref();
+    // Evaluate the projects in parallel, collect the results in order
+    std::vector<std::unique_ptr<ProjectTask>> tasks;
+    tasks.reserve(proFiles.size());
+    for (const QString &proFile : proFiles) {
+        tasks.push_back(std::make_unique<ProjectTask>([=] {
+            return processProjectFile(topLevel, proFile, translationsVariables, option, vfs,
+                                      cache);
+        }));
+        QThreadPool::globalInstance()->start(tasks.back().get());
     }
+    for (const auto &task : tasks)
+        append(task->takeResult());
     return result;
 }
 
@@ -339,6 +467,8 @@ int main(int argc, char **argv)
     QString outDir = QDir::currentPath();
     QHash<QString, QString> outDirMap;
     QString outputFilePath;
+    QString dependenciesFilePath;
+    QString proCacheDir;
     int proDebug = 0;
 
     for (int i = 1; i < args.size(); ++i) {
@@ -355,10 +485,24 @@ int main(int argc, char **argv)
                 return 1;
             }
             outputFilePath = args[i];
+        } else if (arg == QLatin1String("-dependencies-out")) {
+            ++i;
+            if (i == argc) {
+                printErr(u"The option -dependencies-out requires a parameter.\n"_s);
+                return 1;
+            }
+            dependenciesFilePath = args[i];
         } else if (arg == QLatin1String("-silent")) {
             evalHandler.verbose = false;
         } else if (arg == QLatin1String("-pro-debug")) {
             proDebug++;
+        } else if (arg == QLatin1String("-pro-cache")) {
+            ++i;
+            if (i == argc) {
+                printErr(u"The -pro-cache option should be followed by a directory name.\n"_s);
+                return 1;
+            }
+            proCacheDir = QDir::cleanPath(QFileInfo(args[i]).absoluteFilePath());
         } else if (arg == QLatin1String("-version")) {
             printOut(QStringLiteral("lprodump version %1\n").arg(QLatin1String(QT_VERSION_STR)));
             return 0;
@@ -422,11 +566,13 @@ int main(int argc, char **argv)
     option.initProperties();
     option.setCommandLineArguments(QDir::currentPath(),
                                    QStringList() << QLatin1String("CONFIG+=lupdate_run"));
+    ProFileEvaluator::initialize();
     QMakeVfs vfs;
-    QMakeParser parser(0, &vfs, &evalHandler);
+    vfs.setDiskCacheDirectory(proCacheDir);
+    ProFileCache cache;
 
     QJsonArray results = processProjects(true, proFiles, translationsVariables, outDirMap, &option,
-                                         &vfs, &parser, &fail);
+                                         &vfs, &cache, &fail);
     if (fail)
         return 1;
 
@@ -442,5 +588,9 @@ int main(int argc, char **argv)
         f.write(output);
         f.write("\n");
     }
+    if (!dependenciesFilePath.isEmpty() && !writeDependencies(dependenciesFilePath, &vfs)) {
+        printErr(QStringLiteral("lprodump error: Cannot write %1.\n").arg(dependenciesFilePath));
+        return 1;
+    }
     return 0;
 }
@@ -38,6 +38,11 @@ passed to lrelease.
 Options:
     -help  Display this information and exit
     -keep  Keep the temporary project dump around
+    -pro-cache <directory>
+           Cache parsed .pro/.pri/.prf files and the resulting project
+           description in the given directory. Subsequent runs skip
+           evaluating the projects if none of the files involved changed.
+           Warnings from evaluating the projects are not repeated then
     -silent
            Do not explain what is being done
     -version
@@ -70,6 +75,12 @@ int main(int argc, char **argv)
     for (int i = 1; i < argc; ++i) {
         if (!strcmp(argv[i], "-keep")) {
             keepProjectDescription = true;
+        } else if (!strcmp(argv[i], "-pro-cache")) {
+            if (++i == argc) {
+                printErr(u"The -pro-cache option should be followed by a directory name.\n"_s);
+                return 1;
+            }
+            lprodumpOptions << QStringLiteral("-pro-cache") << QString::fromLocal8Bit(argv[i]);
         } else if (!strcmp(argv[i], "-silent")) {
             const QString arg = QString::fromLocal8Bit(argv[i]);
             lprodumpOptions << arg;
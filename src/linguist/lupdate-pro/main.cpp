@@ -50,6 +50,11 @@ Options:
            Virtual output directory for processing subsequent .pro files.
     -pro-debug
            Trace processing .pro files. Specify twice for more verbosity.
+    -pro-cache <directory>
+           Cache parsed .pro/.pri/.prf files and the resulting project
+           description in the given directory. Subsequent runs skip
+           evaluating the projects if none of the files involved changed.
+           Warnings from evaluating the projects are not repeated then.
     -version
            Display the version of lupdate-pro and exit.
 )"_s);
@@ -103,6 +108,13 @@ int main(int argc, char **argv)
             }
             lprodumpOptions << arg << args[i];
             hasProFiles = true;
+        } else if (arg == QLatin1String("-pro-cache")) {
+            ++i;
+            if (i == argc) {
+                printErr(u"The -pro-cache option should be followed by a directory name.\n"_s);
+                return 1;
+            }
+            lprodumpOptions << arg << args[i];
         } else if (arg == QLatin1String("-pro-out")) {
             ++i;
             if (i == argc) {
@@ -4,8 +4,13 @@
 #ifndef PROFILEUTILS_H
 #define PROFILEUTILS_H
 
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qdatetime.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
 #include <QtCore/qstring.h>
 #include <QtCore/qstringlist.h>
+#include <QtCore/qtimezone.h>
 
 #include <algorithm>
 
@@ -26,4 +31,22 @@ inline QStringList extractProFiles(QStringList *files)
     return result;
 }
 
+// Hash of the contents of a file, empty if it cannot be read
+inline QByteArray fileContentHash(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&file);
+    return hash.result().toHex();
+}
+
+// Modification time of a directory, which changes when entries are added or removed
+inline QByteArray directoryTimeStamp(const QString &dirPath)
+{
+    const QDateTime lastModified = QFileInfo(dirPath).lastModified(QTimeZone::UTC);
+    return QByteArray::number(lastModified.isValid() ? lastModified.toMSecsSinceEpoch() : 0);
+}
+
 #endif // PROFILEUTILS_H
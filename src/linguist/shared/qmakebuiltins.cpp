@@ -1025,6 +1025,9 @@ QMakeEvaluator::VisitReturn QMakeEvaluator::evaluateBuiltinExpand(
         for (int d = 0; d < dirs.size(); d++) {
             QString dir = dirs[d];
             QDir qdir(pfx + dir);
+#ifndef PROEVALUATOR_FULL
+            m_vfs->addListedDirectory(QDir::cleanPath(qdir.absolutePath()));
+#endif
             for (int i = 0, count = int(qdir.count()); i < count; ++i) {
                 if (qdir[i] == statics.strDot || qdir[i] == statics.strDotDot)
                     continue;
@@ -7,6 +7,7 @@
 #include "ioutils.h"
 using namespace QMakeInternal;
 
+#include <qdatastream.h>
 #include <qfile.h>
 #ifdef PROPARSER_THREAD_SAFE
 # include <qthreadpool.h>
@@ -192,7 +193,7 @@ ProFile *QMakeParser::parsedProFile(const QString &fileName, ParseFlags flags)
 #endif
             QString contents;
             if (readFile(id, flags, &contents)) {
-                pro = parsedProBlock(QStringView(contents), id, fileName, 1, FullGrammar);
+                pro = parsedFileContents(id, fileName, contents);
                 pro->itemsRef()->squeeze();
                 pro->ref();
             } else {
@@ -213,7 +214,7 @@ ProFile *QMakeParser::parsedProFile(const QString &fileName, ParseFlags flags)
     } else {
         QString contents;
         if (readFile(id, flags, &contents))
-            pro = parsedProBlock(QStringView(contents), id, fileName, 1, FullGrammar);
+            pro = parsedFileContents(id, fileName, contents);
         else
             pro = nullptr;
     }
@@ -234,6 +235,42 @@ void QMakeParser::discardFileFromCache(int id)
         m_cache->discardFile(id);
 }
 
+// Parses a whole file, using the disk cache of the VFS if it is enabled.
+// Only files without errors and warnings are cached, so that these get
+// reported again.
+ProFile *QMakeParser::parsedFileContents(int id, const QString &fileName, const QString &contents)
+{
+    const bool useDiskCache = !m_vfs->diskCacheDirectory().isEmpty();
+    const QByteArray version(QT_VERSION_STR);
+
+    QByteArray data;
+    if (useDiskCache && m_vfs->readDiskCache(id, contents, &data)) {
+        QDataStream in(data);
+        in.setVersion(QDataStream::Qt_6_0);
+        QByteArray dataVersion;
+        bool hostBuild;
+        QString items;
+        in >> dataVersion >> hostBuild >> items;
+        if (in.status() == QDataStream::Ok && dataVersion == version) {
+            ProFile *pro = new ProFile(id, fileName);
+            pro->setHostBuild(hostBuild);
+            *pro->itemsRef() = items;
+            return pro;
+        }
+    }
+
+    m_hadMessages = false;
+    ProFile *pro = parsedProBlock(QStringView(contents), id, fileName, 1, FullGrammar);
+    if (useDiskCache && pro->isOk() && !m_hadMessages) {
+        data.clear();
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        out << version << pro->isHostBuild() << pro->items();
+        m_vfs->writeDiskCache(id, contents, data);
+    }
+    return pro;
+}
+
 bool QMakeParser::readFile(int id, ParseFlags flags, QString *contents)
 {
     QString errStr;
@@ -1285,6 +1322,7 @@ bool QMakeParser::resolveVariable(ushort *xprPtr, int tlen, int needSep, ushort
 
 void QMakeParser::message(int type, const QString &msg) const
 {
+    m_hadMessages = true;
     if (!m_inError && m_handler)
         m_handler->message(type, msg, m_proFile->fileName(), m_lineNo);
 }
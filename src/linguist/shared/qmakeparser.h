@@ -110,6 +110,7 @@ private:
     };
 
     bool readFile(int id, QMakeParser::ParseFlags flags, QString *contents);
+    ProFile *parsedFileContents(int id, const QString &fileName, const QString &contents);
     void read(ProFile *pro, QStringView content, int line, SubGrammar grammar);
 
     ALWAYS_INLINE void putTok(ushort *&tokPtr, ushort tok);
@@ -154,6 +155,7 @@ private:
     ScopeState m_state;
     int m_markLine; // Put marker for this line
     bool m_inError; // Current line had a parsing error; suppress followup error messages
+    mutable bool m_hadMessages = false; // Errors or warnings were reported; do not cache the file
     bool m_canElse; // Conditionals met on previous line, but no scope was opened
     int m_invert; // Pending conditional is negated
     enum { NoOperator, AndOperator, OrOperator } m_operator; // Pending conditional is ORed/ANDed
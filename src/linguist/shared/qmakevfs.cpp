@@ -6,9 +6,12 @@
 #include "ioutils.h"
 using namespace QMakeInternal;
 
+#include <qcryptographichash.h>
+#include <qdatetime.h>
 #include <qdir.h>
 #include <qfile.h>
 #include <qfileinfo.h>
+#include <qsavefile.h>
 
 #define fL1S(s) QString::fromLatin1(s)
 
@@ -195,6 +198,7 @@ QMakeVfs::ReadResult QMakeVfs::readFile(int id, QString *contents, QString *errS
     }
 #ifndef PROEVALUATOR_FULL
     m_files[id] = m_magicExisting;
+    m_readFiles.insert(id);
 #endif
 
     QByteArray bcont = file.readAll();
@@ -207,6 +211,47 @@ QMakeVfs::ReadResult QMakeVfs::readFile(int id, QString *contents, QString *errS
     return ReadOk;
 }
 
+// Cache files are named after a hash of the file name. They start with a key
+// line made of the modification time and a hash of the contents.
+QString QMakeVfs::diskCacheFileName(int id, const QString &contents, QByteArray *key)
+{
+    const QString fn = fileNameForId(id);
+    const QDateTime lastModified = QFileInfo(fn).lastModified(QTimeZone::UTC);
+    const QByteArrayView contentsData(reinterpret_cast<const char *>(contents.constData()),
+                                      contents.size() * qsizetype(sizeof(QChar)));
+    *key = QByteArray::number(lastModified.isValid() ? lastModified.toMSecsSinceEpoch() : 0)
+            + ' ' + QCryptographicHash::hash(contentsData, QCryptographicHash::Sha1).toHex()
+            + '\n';
+    return m_diskCacheDir + QLatin1Char('/')
+            + QString::fromLatin1(QCryptographicHash::hash(fn.toUtf8(),
+                                                           QCryptographicHash::Sha1).toHex());
+}
+
+bool QMakeVfs::readDiskCache(int id, const QString &contents, QByteArray *data)
+{
+    if (m_diskCacheDir.isEmpty())
+        return false;
+    QByteArray key;
+    QFile file(diskCacheFileName(id, contents, &key));
+    if (!file.open(QIODevice::ReadOnly) || file.readLine() != key)
+        return false;
+    *data = file.readAll();
+    return true;
+}
+
+void QMakeVfs::writeDiskCache(int id, const QString &contents, const QByteArray &data)
+{
+    if (m_diskCacheDir.isEmpty() || !QDir().mkpath(m_diskCacheDir))
+        return;
+    QByteArray key;
+    QSaveFile file(diskCacheFileName(id, contents, &key));
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(key);
+        file.write(data);
+        file.commit();
+    }
+}
+
 bool QMakeVfs::exists(const QString &fn, VfsFlags flags)
 {
 #ifndef PROEVALUATOR_FULL
@@ -251,6 +296,43 @@ void QMakeVfs::invalidateContents()
     QMutexLocker locker(&m_mutex);
 # endif
     m_files.clear();
+    m_readFiles.clear();
+    m_listedDirs.clear();
+}
+
+QHash<QString, QMakeVfs::FileState> QMakeVfs::accessedFiles()
+{
+# ifdef PROEVALUATOR_THREAD_SAFE
+    QMutexLocker locker(&m_mutex);
+# endif
+    QHash<QString, FileState> result;
+    for (auto it = m_files.cbegin(), end = m_files.cend(); it != end; ++it) {
+        FileState state;
+        if (it->constData() == m_magicMissing.constData())
+            state = FileMissing;
+        else if (it->constData() == m_magicExisting.constData())
+            state = m_readFiles.contains(it.key()) ? FileRead : FileExists;
+        else
+            continue; // virtual file
+        result.insert(fileNameForId(it.key()), state);
+    }
+    return result;
+}
+
+void QMakeVfs::addListedDirectory(const QString &dir)
+{
+# ifdef PROEVALUATOR_THREAD_SAFE
+    QMutexLocker locker(&m_mutex);
+# endif
+    m_listedDirs.insert(dir);
+}
+
+QStringList QMakeVfs::listedDirectories()
+{
+# ifdef PROEVALUATOR_THREAD_SAFE
+    QMutexLocker locker(&m_mutex);
+# endif
+    return m_listedDirs.values();
 }
 #endif
 
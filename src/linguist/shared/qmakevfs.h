@@ -8,7 +8,9 @@
 
 #include <qiodevice.h>
 #include <qhash.h>
+#include <qset.h>
 #include <qstring.h>
+#include <qstringlist.h>
 #ifdef PROEVALUATOR_THREAD_SAFE
 # include <qmutex.h>
 #endif
@@ -61,9 +63,27 @@ public:
 #ifndef PROEVALUATOR_FULL
     void invalidateCache();
     void invalidateContents();
+
+    enum FileState { FileMissing, FileExists, FileRead };
+    // The real files accessed so far and what is known about them
+    QHash<QString, FileState> accessedFiles();
+    // Directories whose entries were listed, like by $$files()
+    void addListedDirectory(const QString &dir);
+    QStringList listedDirectories();
 #endif
 
+    // Persistent cache for data derived from file contents (like parsed files).
+    // Entries are keyed by file name, modification time and a hash of the contents.
+    void setDiskCacheDirectory(const QString &dir) { m_diskCacheDir = dir; }
+    QString diskCacheDirectory() const { return m_diskCacheDir; }
+    bool readDiskCache(int id, const QString &contents, QByteArray *data);
+    void writeDiskCache(int id, const QString &contents, const QByteArray &data);
+
 private:
+    QString diskCacheFileName(int id, const QString &contents, QByteArray *key);
+
+    QString m_diskCacheDir;
+
 #ifdef PROEVALUATOR_THREAD_SAFE
     static QMutex s_mutex;
 #endif
@@ -93,6 +113,8 @@ private:
     QMutex m_mutex;
 # endif
     QHash<int, QString> m_files;
+    QSet<int> m_readFiles;
+    QSet<QString> m_listedDirs;
     QString m_magicMissing;
     QString m_magicExisting;
 #endif
@@ -7,7 +7,10 @@
 #include "profileutils.h"
 
 #include <QtCore/qcoreapplication.h>
+#include <QtCore/qcryptographichash.h>
 #include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
 #include <QtCore/qregularexpression.h>
 
 #include <cstdlib>
@@ -96,6 +99,94 @@ void runInternalQtTool(const QString &toolName, const QStringList &arguments)
         exit(exitCode);
 }
 
+// Key of a cached project description: Everything that affects the output of
+// lprodump apart from the files it reads. Options that only affect diagnostics
+// or the cache location are left out, so runs that differ only in those share
+// entries. Relative paths are resolved against the current directory, which is
+// part of the key, so runs from different directories never share entries.
+static QString projectDescriptionKey(const QStringList &args)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    const auto addString = [&hash](const QString &s) {
+        hash.addData(s.toUtf8());
+        hash.addData(QByteArrayView("\0", 1));
+    };
+    const auto addPath = [&addString](const QString &path) {
+        addString(QDir::cleanPath(QFileInfo(path).absoluteFilePath()));
+    };
+
+    hash.addData(QByteArrayView(QT_VERSION_STR));
+    hash.addData(QByteArrayView("\0", 1));
+    // lprodump writes the translations of projects before any -pro-out
+    // relative to the current directory
+    addPath(QDir::currentPath());
+    for (qsizetype i = 0; i < args.size(); ++i) {
+        const QString &arg = args.at(i);
+        if (arg == QLatin1String("-silent") || arg == QLatin1String("-pro-debug")) {
+            continue;
+        } else if (arg == QLatin1String("-pro-cache")) {
+            ++i;
+        } else if (arg == QLatin1String("-pro") || arg == QLatin1String("-pro-out")) {
+            addString(arg);
+            if (++i < args.size())
+                addPath(args.at(i));
+        } else if (arg == QLatin1String("-translations-variables")) {
+            addString(arg);
+            if (++i < args.size())
+                addString(args.at(i));
+        } else {
+            addPath(arg);
+        }
+    }
+    for (const char *var : { "QMAKE", "QMAKESPEC", "XQMAKESPEC", "QMAKEPATH", "QMAKEFEATURES" }) {
+        hash.addData(qgetenv(var));
+        hash.addData(QByteArrayView("\0", 1));
+    }
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+// Checks the dependency list written by lprodump's -dependencies-out option.
+// Each line consists of a type, a value and a path separated by single spaces.
+static bool dependenciesUpToDate(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return false;
+    bool empty = true;
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine();
+        if (line.endsWith('\n'))
+            line.chop(1);
+        const qsizetype valueEnd = line.indexOf(' ', 2);
+        if (line.size() < 2 || line.at(1) != ' ' || valueEnd < 0)
+            return false;
+        const QByteArray value = line.mid(2, valueEnd - 2);
+        const QString path = QString::fromUtf8(line.mid(valueEnd + 1));
+        switch (line.at(0)) {
+        case 'F':
+            if (fileContentHash(path) != value)
+                return false;
+            break;
+        case 'E':
+            if (!QFileInfo::exists(path))
+                return false;
+            break;
+        case 'M':
+            if (QFileInfo::exists(path))
+                return false;
+            break;
+        case 'D':
+            if (directoryTimeStamp(path) != value)
+                return false;
+            break;
+        default:
+            return false;
+        }
+        empty = false;
+    }
+    return !empty;
+}
+
 std::unique_ptr<QTemporaryFile> createProjectDescription(QStringList args)
 {
     std::unique_ptr<QTemporaryFile> file(new QTemporaryFile(QStringLiteral("XXXXXX.json")));
@@ -103,12 +194,41 @@ std::unique_ptr<QTemporaryFile> createProjectDescription(QStringList args)
         rtPrintErr(FMT::tr("Cannot create temporary file: %1\n").arg(file->errorString()));
         exit(1);
     }
+
+    // With a cache directory, reuse the description of an earlier run with the
+    // same arguments unless one of the files lprodump looked at has changed.
+    QString cachedDescription;
+    QString cachedDependencies;
+    const qsizetype cacheOption = args.indexOf(QStringLiteral("-pro-cache"));
+    if (cacheOption >= 0 && cacheOption + 1 < args.size()) {
+        const QString key = args.at(cacheOption + 1) + QLatin1Char('/')
+                + projectDescriptionKey(args);
+        cachedDescription = key + QLatin1String(".json");
+        cachedDependencies = key + QLatin1String(".deps");
+        if (dependenciesUpToDate(cachedDependencies)) {
+            QFile cached(cachedDescription);
+            if (cached.open(QIODevice::ReadOnly) && file->write(cached.readAll()) == cached.size()
+                    && file->flush()) {
+                file->close();
+                return file;
+            }
+            file->resize(0);
+        }
+        QFile::remove(cachedDescription);
+        QFile::remove(cachedDependencies);
+        args << QStringLiteral("-dependencies-out") << cachedDependencies;
+    }
+
     file->close();
     args << QStringLiteral("-out") << file->fileName();
     const int exitCode = runInternalQtToolHelper(QStringLiteral("lprodump"), args);
     if (exitCode != 0) {
         file.reset();
+        if (!cachedDependencies.isEmpty())
+            QFile::remove(cachedDependencies);
         exit(exitCode);
     }
+    if (!cachedDescription.isEmpty())
+        QFile::copy(file->fileName(), cachedDescription);
     return file;
 }
@@ -5,6 +5,8 @@
 #include <stdlib.h>
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QHash>
+#include <QtCore/QQueue>
 #include <QtCore/QRegularExpression>
 #include <QtCore/QStringList>
 #include <QtCore/qmetaobject.h>
@@ -16,6 +18,8 @@
 #include <QtDBus/QDBusVariant>
 #include <QtDBus/QDBusArgument>
 #include <QtDBus/QDBusMessage>
+#include <QtDBus/QDBusPendingCall>
+#include <QtDBus/QDBusPendingReply>
 #include <QtDBus/QDBusReply>
 #include <private/qdbusutil_p.h>
 
@@ -25,10 +29,11 @@ QT_END_NAMESPACE
 
 static QDBusConnection connection(QLatin1String(""));
 static bool printArgumentsLiterally = false;
+static bool listRecursively = false;
 
 static void showUsage()
 {
-    printf("Usage: qdbus [--system] [--bus busaddress] [--literal] [servicename] [path] [method] [args]\n"
+    printf("Usage: qdbus [--system] [--bus busaddress] [--literal] [--recursive] [servicename] [path] [method] [args]\n"
            "\n"
            "  servicename       the service to connect to (e.g., org.freedesktop.DBus)\n"
            "  path              the path to the object (e.g., /)\n"
@@ -37,11 +42,13 @@ static void showUsage()
            "With 0 arguments, qdbus will list the services available on the bus\n"
            "With just the servicename, qdbus will list the object paths available on the service\n"
            "With service name and object path, qdbus will list the methods, signals and properties available on the object\n"
+           "With --recursive, qdbus will list the methods, signals and properties of all objects below the path (or /)\n"
            "\n"
            "Options:\n"
            "  --system          connect to the system bus\n"
            "  --bus busaddress  connect to a custom bus\n"
            "  --literal         print replies literally\n"
+           "  --recursive       list the interfaces of the whole object tree\n"
            );
 }
 
@@ -83,46 +90,105 @@ static void printArg(const QVariant &v)
     }
 }
 
-static void listObjects(const QString &service, const QString &path)
+// Keeps the number of calls in flight well below the number of pending replies
+// a bus allows per connection (128 by default on the system bus)
+static const qsizetype maxPendingCalls = 64;
+
+static QDBusPendingCall introspect(const QString &service, const QString &path)
 {
     // make a low-level call, to avoid introspecting the Introspectable interface
-    QDBusMessage call = QDBusMessage::createMethodCall(service, path.isEmpty() ? QLatin1String("/") : path,
+    QDBusMessage call = QDBusMessage::createMethodCall(service, path,
                                                        QLatin1String("org.freedesktop.DBus.Introspectable"),
                                                        QLatin1String("Introspect"));
-    QDBusReply<QString> xml = connection.call(call);
+    return connection.asyncCall(call);
+}
 
-    if (path.isEmpty()) {
-        // top-level
-        if (xml.isValid()) {
-            printf("/\n");
-        } else {
-            QDBusError err = xml.error();
-            if (err.type() == QDBusError::ServiceUnknown)
-                fprintf(stderr, "Service '%s' does not exist.\n", qPrintable(service));
-            else
-                printf("Error: %s\n%s\n", qPrintable(err.name()), qPrintable(err.message()));
-            exit(2);
+// Visits an object tree depth-first. The objects that are visited next are
+// introspected ahead of time, so that the round-trips overlap.
+class ObjectTreeWalker
+{
+public:
+    explicit ObjectTreeWalker(const QString &service, const QString &path)
+        : service(service), stack(1, path)
+    {}
+
+    bool atEnd() const { return stack.isEmpty(); }
+
+    // Takes the next object and returns the reply to its introspection
+    QDBusMessage takeNext(QString *path)
+    {
+        *path = stack.takeLast();
+        auto it = pending.find(*path);
+        QDBusPendingCall call = it != pending.end() ? *it : introspect(service, *path);
+        if (it != pending.end())
+            pending.erase(it);
+        prefetch();
+        call.waitForFinished();
+        return call.reply();
+    }
+
+    // Queues the child nodes of an object, to be visited before its siblings
+    void addChildren(const QString &path, const QDomElement &node)
+    {
+        const QString prefix = path == QLatin1String("/") ? QString() : path;
+        const qsizetype top = stack.size();
+        QDomElement child = node.firstChildElement(QLatin1String("node"));
+        while (!child.isNull()) {
+            stack.insert(top, prefix + QLatin1Char('/') + child.attribute(QLatin1String("name")));
+            child = child.nextSiblingElement(QLatin1String("node"));
         }
-    } else if (!xml.isValid()) {
-        // this is not the first object, just fail silently
-        return;
+        prefetch();
     }
 
-    QDomDocument doc;
-    doc.setContent(xml.value());
-    QDomElement node = doc.documentElement();
-    QDomElement child = node.firstChildElement();
-    while (!child.isNull()) {
-        if (child.tagName() == QLatin1String("node")) {
-            QString sub = path + QLatin1Char('/') + child.attribute(QLatin1String("name"));
-            printf("%s\n", qPrintable(sub));
-            listObjects(service, sub);
+private:
+    void prefetch()
+    {
+        for (qsizetype i = stack.size() - 1; i >= 0 && pending.size() < maxPendingCalls; --i) {
+            if (!pending.contains(stack.at(i)))
+                pending.insert(stack.at(i), introspect(service, stack.at(i)));
         }
-        child = child.nextSiblingElement();
+    }
+
+    const QString service;
+    QStringList stack; // the last entry is visited next
+    QHash<QString, QDBusPendingCall> pending;
+};
+
+static void printIntrospectionError(const QString &service, const QDBusError &err)
+{
+    if (err.type() == QDBusError::ServiceUnknown)
+        fprintf(stderr, "Service '%s' does not exist.\n", qPrintable(service));
+    else
+        printf("Error: %s\n%s\n", qPrintable(err.name()), qPrintable(err.message()));
+}
+
+static void listObjects(const QString &service)
+{
+    ObjectTreeWalker walker(service, QLatin1String("/"));
+    bool topLevel = true;
+    while (!walker.atEnd()) {
+        QString path;
+        QDBusReply<QString> xml = walker.takeNext(&path);
+        if (topLevel && !xml.isValid()) {
+            printIntrospectionError(service, xml.error());
+            exit(2);
+        }
+        topLevel = false;
+
+        printf("%s\n", qPrintable(path));
+        if (!xml.isValid()) {
+            // this is not the first object, just fail silently
+            continue;
+        }
+
+        QDomDocument doc;
+        doc.setContent(xml.value());
+        walker.addChildren(path, doc.documentElement());
     }
 }
 
-static void listInterface(const QString &service, const QString &path, const QString &interface)
+static bool listInterface(const QString &service, const QString &path, const QString &interface,
+                          const char *indent)
 {
     QDBusInterface iface(service, path, interface, connection);
     if (!iface.isValid()) {
@@ -130,14 +196,14 @@ static void listInterface(const QString &service, const QString &path, const QSt
         fprintf(stderr, "Interface '%s' not available in object %s at %s:\n%s (%s)\n",
                 qPrintable(interface), qPrintable(path), qPrintable(service),
                 qPrintable(err.name()), qPrintable(err.message()));
-        exit(1);
+        return false;
     }
     const QMetaObject *mo = iface.metaObject();
 
     // properties
     for (int i = mo->propertyOffset(); i < mo->propertyCount(); ++i) {
         QMetaProperty mp = mo->property(i);
-        printf("property ");
+        printf("%sproperty ", indent);
 
         if (mp.isReadable() && mp.isWritable())
             printf("readwrite");
@@ -155,7 +221,7 @@ static void listInterface(const QString &service, const QString &path, const QSt
 
         QByteArray signature = mm.methodSignature();
         signature.truncate(signature.indexOf('('));
-        printf("%s %s%s%s %s.%s(",
+        printf("%s%s %s%s%s %s.%s(", indent,
                mm.methodType() == QMetaMethod::Signal ? "signal" : "method",
                mm.tag(), *mm.tag() ? " " : "",
                *mm.typeName() ? mm.typeName() : "void",
@@ -174,40 +240,70 @@ static void listInterface(const QString &service, const QString &path, const QSt
         }
         printf(")\n");
     }
+    return true;
+}
+
+static bool listInterfaces(const QString &service, const QString &path, const QDomElement &node,
+                           const char *indent = "")
+{
+    bool ok = true;
+    QDomElement child = node.firstChildElement();
+    while (!child.isNull()) {
+        if (child.tagName() == QLatin1String("interface")) {
+            QString ifaceName = child.attribute(QLatin1String("name"));
+            if (QDBusUtil::isValidInterfaceName(ifaceName)) {
+                ok &= listInterface(service, path, ifaceName, indent);
+            } else {
+                qWarning("Invalid D-BUS interface name '%s' found while parsing introspection",
+                         qPrintable(ifaceName));
+            }
+        }
+        child = child.nextSiblingElement();
+    }
+    return ok;
 }
 
 static void listAllInterfaces(const QString &service, const QString &path)
 {
-    // make a low-level call, to avoid introspecting the Introspectable interface
-    QDBusMessage call = QDBusMessage::createMethodCall(service, path.isEmpty() ? QLatin1String("/") : path,
-                                                       QLatin1String("org.freedesktop.DBus.Introspectable"),
-                                                       QLatin1String("Introspect"));
-    QDBusReply<QString> xml = connection.call(call);
+    QDBusPendingCall call = introspect(service, path);
+    call.waitForFinished();
+    QDBusReply<QString> xml = call.reply();
 
     if (!xml.isValid()) {
-        QDBusError err = xml.error();
-        if (err.type() == QDBusError::ServiceUnknown)
-            fprintf(stderr, "Service '%s' does not exist.\n", qPrintable(service));
-        else
-            printf("Error: %s\n%s\n", qPrintable(err.name()), qPrintable(err.message()));
+        printIntrospectionError(service, xml.error());
         exit(2);
     }
 
     QDomDocument doc;
     doc.setContent(xml.value());
-    QDomElement node = doc.documentElement();
-    QDomElement child = node.firstChildElement();
-    while (!child.isNull()) {
-        if (child.tagName() == QLatin1String("interface")) {
-            QString ifaceName = child.attribute(QLatin1String("name"));
-            if (QDBusUtil::isValidInterfaceName(ifaceName))
-                listInterface(service, path, ifaceName);
-            else {
-                qWarning("Invalid D-BUS interface name '%s' found while parsing introspection",
-                         qPrintable(ifaceName));
+    if (!listInterfaces(service, path, doc.documentElement()))
+        exit(1);
+}
+
+// Lists every object below path, each followed by its indented interfaces
+static void dumpObjects(const QString &service, const QString &path)
+{
+    ObjectTreeWalker walker(service, path);
+    bool topLevel = true;
+    while (!walker.atEnd()) {
+        QString objectPath;
+        QDBusReply<QString> xml = walker.takeNext(&objectPath);
+        if (!xml.isValid()) {
+            if (topLevel) {
+                printIntrospectionError(service, xml.error());
+                exit(2);
             }
+            // the object may have gone away in the meantime
+            continue;
         }
-        child = child.nextSiblingElement();
+        topLevel = false;
+
+        QDomDocument doc;
+        doc.setContent(xml.value());
+        const QDomElement node = doc.documentElement();
+        printf("%s\n", qPrintable(objectPath));
+        listInterfaces(service, objectPath, node, "  ");
+        walker.addChildren(objectPath, node);
     }
 }
 
@@ -398,9 +494,24 @@ static void printAllServices(QDBusConnectionInterface *bus)
     const QStringList services = bus->registeredServiceNames();
     QMap<QString, QStringList> servicesWithAliases;
 
+    // unique names own themselves, only the well-known names need to be looked up
+    QStringList wellKnownNames;
     for (const QString &serviceName : services) {
-        QDBusReply<QString> reply = bus->serviceOwner(serviceName);
-        QString owner = reply;
+        if (serviceName.startsWith(QLatin1Char(':')))
+            servicesWithAliases[serviceName].append(serviceName);
+        else
+            wellKnownNames.append(serviceName);
+    }
+
+    // keep several lookups in flight instead of waiting for each reply in turn
+    QQueue<QDBusPendingReply<QString>> replies;
+    qsizetype sent = 0;
+    for (const QString &serviceName : std::as_const(wellKnownNames)) {
+        for (; sent < wellKnownNames.size() && replies.size() < maxPendingCalls; ++sent)
+            replies.enqueue(bus->asyncCall(QLatin1String("GetNameOwner"), wellKnownNames.at(sent)));
+        QDBusPendingReply<QString> reply = replies.dequeue();
+        reply.waitForFinished();
+        QString owner = reply.isError() ? QString() : reply.value();
         if (owner.isEmpty())
             owner = serviceName;
         servicesWithAliases[owner].append(serviceName);
@@ -434,6 +545,8 @@ int main(int argc, char **argv)
             }
         } else if (arg == QLatin1String("--literal")) {
             printArgumentsLiterally = true;
+        } else if (arg == QLatin1String("--recursive")) {
+            listRecursively = true;
         } else if (arg == QLatin1String("--help")) {
             showUsage();
             return 0;
@@ -473,7 +586,10 @@ int main(int argc, char **argv)
     }
 
     if (args.isEmpty()) {
-        listObjects(service, QString());
+        if (listRecursively)
+            dumpObjects(service, QLatin1String("/"));
+        else
+            listObjects(service);
         return 0;
     }
 
@@ -483,7 +599,10 @@ int main(int argc, char **argv)
         return 1;
     }
     if (args.isEmpty()) {
-        listAllInterfaces(service, path);
+        if (listRecursively)
+            dumpObjects(service, path);
+        else
+            listAllInterfaces(service, path);
         return 0;
     }
 
@@ -6,18 +6,22 @@
 #include <QtCore/QDebug>
 #include <QtCore/QList>
 
+#include <QtDBus/QDBusMessage>
 #include <QtDBus/QDBusObjectPath>
-#include <QtDBus/QDBusInterface>
-#include <QtDBus/QDBusReply>
+#include <QtDBus/QDBusPendingCallWatcher>
+#include <QtDBus/QDBusPendingReply>
 
 #include <QtXml/QDomDocument>
 
+#include <algorithm>
+
 using namespace Qt::StringLiterals;
 
 struct QDBusItem
 {
     inline QDBusItem(QDBusModel::Type aType, const QString &aName, QDBusItem *aParent = 0)
-        : type(aType), parent(aParent), isPrefetched(type != QDBusModel::PathItem), name(aName)
+        : type(aType), parent(aParent), isPrefetched(type != QDBusModel::PathItem),
+          isFetching(false), name(aName)
         {}
     inline ~QDBusItem()
     {
@@ -43,114 +47,359 @@ struct QDBusItem
     QDBusItem *parent;
     QList<QDBusItem *> children;
     bool isPrefetched;
+    bool isFetching;
     QString name;
     QString caption;
     QString typeSignature;
 };
 
-QDomDocument QDBusModel::introspect(const QString &path)
+static QString childPath(const QString &path, const QString &name)
 {
-    QDomDocument doc;
-
-    QDBusInterface iface(service, path, "org.freedesktop.DBus.Introspectable"_L1, c);
-    if (!iface.isValid()) {
-        QDBusError err(iface.lastError());
-        emit busError(tr("Cannot introspect object %1 at %2:\n  %3 (%4)\n")
-                              .arg(path)
-                              .arg(service)
-                              .arg(err.name())
-                              .arg(err.message()));
-        return doc;
-    }
-
-    QDBusReply<QString> xml = iface.call("Introspect"_L1);
-
-    if (!xml.isValid()) {
-        QDBusError err(xml.error());
-        if (err.isValid()) {
-            emit busError(tr("Call to object %1 at %2:\n  %3 (%4) failed\n")
-                                  .arg(path)
-                                  .arg(service)
-                                  .arg(err.name())
-                                  .arg(err.message()));
-        } else {
-            emit busError(tr("Invalid XML received from object %1 at %2\n").arg(path).arg(service));
-        }
-        return doc;
-    }
-
-    doc.setContent(xml.value());
-    return doc;
+    return path.endsWith('/'_L1) ? path + name : path + '/'_L1 + name;
 }
 
-void QDBusModel::addMethods(QDBusItem *parent, const QDomElement &iface)
+static void addMembers(QDBusObjectDescription::Entry *entry, const QDomElement &iface)
 {
-    Q_ASSERT(parent);
-
     QDomElement child = iface.firstChildElement();
     while (!child.isNull()) {
-        QDBusItem *item = nullptr;
+        QDBusObjectDescription::Member member;
+        member.name = child.attribute("name"_L1);
         if (child.tagName() == "method"_L1) {
-            item = new QDBusItem(QDBusModel::MethodItem, child.attribute("name"_L1), parent);
-            item->caption = tr("Method: %1").arg(item->name);
+            member.type = QDBusModel::MethodItem;
             //get "type" from <arg> where "direction" is "in"
             QDomElement n = child.firstChildElement();
             while (!n.isNull()) {
                 if (n.attribute("direction"_L1) == "in"_L1)
-                    item->typeSignature += n.attribute("type"_L1);
+                    member.typeSignature += n.attribute("type"_L1);
                 n = n.nextSiblingElement();
             }
+            entry->members.append(member);
         } else if (child.tagName() == "signal"_L1) {
-            item = new QDBusItem(QDBusModel::SignalItem, child.attribute("name"_L1), parent);
-            item->caption = tr("Signal: %1").arg(item->name);
+            member.type = QDBusModel::SignalItem;
+            entry->members.append(member);
         } else if (child.tagName() == "property"_L1) {
-            item = new QDBusItem(QDBusModel::PropertyItem, child.attribute("name"_L1), parent);
-            item->caption = tr("Property: %1").arg(item->name);
+            member.type = QDBusModel::PropertyItem;
+            entry->members.append(member);
         } else {
-            qDebug() << "addMethods: unknown tag:" << child.tagName();
+            qDebug() << "addMembers: unknown tag:" << child.tagName();
         }
-        if (item)
-            parent->children.append(item);
 
         child = child.nextSiblingElement();
     }
 }
 
-void QDBusModel::addPath(QDBusItem *parent)
+static bool parseIntrospection(const QString &xml, QDBusObjectDescription *description)
 {
-    Q_ASSERT(parent);
-
-    QString path = parent->path();
+    QDomDocument doc;
+    if (!doc.setContent(xml))
+        return false;
 
-    QDomDocument doc = introspect(path);
     QDomElement node = doc.documentElement();
     QDomElement child = node.firstChildElement();
     while (!child.isNull()) {
         if (child.tagName() == "node"_L1) {
-            QDBusItem *item = new QDBusItem(QDBusModel::PathItem,
-                                            child.attribute("name"_L1) + '/'_L1, parent);
-            parent->children.append(item);
-
-            addMethods(item, child);
+            description->entries.append({ QDBusModel::PathItem, child.attribute("name"_L1), {} });
         } else if (child.tagName() == "interface"_L1) {
-            QDBusItem *item =
-                    new QDBusItem(QDBusModel::InterfaceItem, child.attribute("name"_L1), parent);
-            parent->children.append(item);
-
-            addMethods(item, child);
+            QDBusObjectDescription::Entry entry{ QDBusModel::InterfaceItem,
+                                                 child.attribute("name"_L1), {} };
+            addMembers(&entry, child);
+            description->entries.append(entry);
         } else {
-            qDebug() << "addPath: Unknown tag name:" << child.tagName();
+            qDebug() << "parseIntrospection: Unknown tag name:" << child.tagName();
         }
         child = child.nextSiblingElement();
     }
+    return true;
+}
+
+QDBusObjectCache::QDBusObjectCache(const QDBusConnection &connection, QObject *parent)
+    : QObject(parent), c(connection)
+{
+}
+
+const QDBusObjectDescription *QDBusObjectCache::description(const QString &service,
+                                                            const QString &path) const
+{
+    const auto serviceIt = descriptions.constFind(service);
+    if (serviceIt == descriptions.cend())
+        return nullptr;
+    const auto it = serviceIt->constFind(path);
+    return it != serviceIt->cend() ? &it.value() : nullptr;
+}
+
+// Returns the description of the object if it is known. Otherwise, starts
+// introspecting it and emits introspected() or introspectionFailed() once
+// done. In both cases the child objects are prefetched, since they are what
+// the user is likely to expand next.
+const QDBusObjectDescription *QDBusObjectCache::fetch(const QString &service,
+                                                      const QString &path)
+{
+    if (const QDBusObjectDescription *result = description(service, path)) {
+        prefetchChildren(service, path, *result);
+        return result;
+    }
+    introspect(service, path, true);
+    return nullptr;
+}
+
+void QDBusObjectCache::waitForFetch(const QString &service, const QString &path)
+{
+    // Delivers the finished() signal before returning
+    if (QDBusPendingCallWatcher *watcher = pending.value(service).value(path).watcher)
+        watcher->waitForFinished();
+}
+
+// Pending introspections of the invalidated objects are dropped, which is
+// reported by introspectionCanceled() once the cache is consistent again.
+void QDBusObjectCache::invalidate(const QString &service, const QString &path)
+{
+    QStringList canceledPaths;
+    const auto serviceIt = pending.find(service);
+    if (path.isEmpty()) {
+        descriptions.remove(service);
+        if (serviceIt != pending.end()) {
+            for (auto it = serviceIt->cbegin(), end = serviceIt->cend(); it != end; ++it) {
+                delete it->watcher;
+                canceledPaths.append(it.key());
+            }
+            pending.erase(serviceIt);
+        }
+        for (const QString &canceledPath : std::as_const(canceledPaths))
+            emit introspectionCanceled(service, canceledPath);
+        return;
+    }
+
+    // The children of the object might have changed as well
+    const QString prefix = path.endsWith(u'/') ? path : path + u'/';
+    const auto isAffected = [&path, &prefix](const QString &candidate) {
+        return candidate == path || candidate.startsWith(prefix);
+    };
+
+    const auto descriptionIt = descriptions.find(service);
+    if (descriptionIt != descriptions.end()) {
+        for (auto it = descriptionIt->begin(); it != descriptionIt->end();) {
+            if (isAffected(it.key()))
+                it = descriptionIt->erase(it);
+            else
+                ++it;
+        }
+    }
+    if (serviceIt != pending.end()) {
+        for (auto it = serviceIt->begin(); it != serviceIt->end();) {
+            if (isAffected(it.key())) {
+                delete it->watcher;
+                canceledPaths.append(it.key());
+                it = serviceIt->erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (serviceIt->isEmpty())
+            pending.erase(serviceIt);
+    }
+    for (const QString &canceledPath : std::as_const(canceledPaths))
+        emit introspectionCanceled(service, canceledPath);
+}
+
+void QDBusObjectCache::introspect(const QString &service, const QString &path,
+                                  bool prefetchChildren)
+{
+    PendingIntrospection &introspection = pending[service][path];
+    introspection.prefetchChildren |= prefetchChildren;
+    if (introspection.watcher)
+        return;
+
+    const QDBusMessage message = QDBusMessage::createMethodCall(
+            service, path, "org.freedesktop.DBus.Introspectable"_L1, "Introspect"_L1);
+    introspection.watcher = new QDBusPendingCallWatcher(c.asyncCall(message), this);
+    connect(introspection.watcher, &QDBusPendingCallWatcher::finished, this,
+            [this, service, path](QDBusPendingCallWatcher *watcher) {
+                introspectionFinished(service, path, watcher);
+            });
+}
+
+void QDBusObjectCache::introspectionFinished(const QString &service, const QString &path,
+                                             QDBusPendingCallWatcher *watcher)
+{
+    // Take the call out of the pending ones first, receivers of the signals
+    // below might invalidate the service.
+    const auto serviceIt = pending.find(service);
+    if (serviceIt == pending.end())
+        return;
+    const PendingIntrospection introspection = serviceIt->take(path);
+    if (serviceIt->isEmpty())
+        pending.erase(serviceIt);
+    Q_ASSERT(introspection.watcher == watcher);
+    watcher->deleteLater();
+
+    const QDBusPendingReply<QString> reply = *watcher;
+    if (reply.isError()) {
+        emit introspectionFailed(service, path, reply.error());
+        return;
+    }
+
+    QDBusObjectDescription result;
+    if (!parseIntrospection(reply.value(), &result)) {
+        emit introspectionFailed(service, path, QDBusError());
+        return;
+    }
+
+    QDBusObjectDescription &stored = descriptions[service][path];
+    stored = std::move(result);
+    if (introspection.prefetchChildren)
+        prefetchChildren(service, path, stored);
+    emit introspected(service, path);
+}
+
+void QDBusObjectCache::prefetchChildren(const QString &service, const QString &path,
+                                        const QDBusObjectDescription &description)
+{
+    // Objects exporting thousands of children would flood the bus otherwise
+    static constexpr qsizetype maxPrefetchedChildren = 16;
+
+    qsizetype count = 0;
+    for (const QDBusObjectDescription::Entry &entry : description.entries) {
+        if (entry.type != QDBusModel::PathItem)
+            continue;
+        const QString child = childPath(path, entry.name);
+        if (!this->description(service, child))
+            introspect(service, child, false);
+        if (++count == maxPrefetchedChildren)
+            break;
+    }
+}
+
+void QDBusModel::objectIntrospected(const QString &aService, const QString &path)
+{
+    if (aService != service)
+        return;
+
+    QDBusItem *item = findPathItem(path);
+    if (!item || !item->isFetching)
+        return;
+
+    item->isFetching = false;
+    if (const QDBusObjectDescription *description = cache->description(service, path))
+        addPath(item, *description);
+}
+
+void QDBusModel::introspectionCanceled(const QString &aService, const QString &path)
+{
+    if (aService != service)
+        return;
+
+    // Allow the view to fetch the object again
+    if (QDBusItem *item = findPathItem(path))
+        item->isFetching = false;
+}
+
+void QDBusModel::introspectionFailed(const QString &aService, const QString &path,
+                                     const QDBusError &err)
+{
+    if (aService != service)
+        return;
+
+    QDBusItem *item = findPathItem(path);
+    if (!item || !item->isFetching)
+        return;
+
+    item->isFetching = false;
+    item->isPrefetched = true;
+    if (err.isValid()) {
+        emit busError(tr("Call to object %1 at %2:\n  %3 (%4) failed\n")
+                              .arg(path)
+                              .arg(service)
+                              .arg(err.name())
+                              .arg(err.message()));
+    } else {
+        emit busError(tr("Invalid XML received from object %1 at %2\n").arg(path).arg(service));
+    }
+}
+
+void QDBusModel::fetchPath(QDBusItem *item)
+{
+    Q_ASSERT(item && item->type == PathItem);
+    if (item->isPrefetched || item->isFetching)
+        return;
+
+    if (const QDBusObjectDescription *description = cache->fetch(service, item->path()))
+        addPath(item, *description);
+    else
+        item->isFetching = true;
+}
+
+void QDBusModel::addPath(QDBusItem *parent, const QDBusObjectDescription &description)
+{
+    Q_ASSERT(parent && parent->children.isEmpty());
 
     parent->isPrefetched = true;
+    if (description.entries.isEmpty())
+        return;
+
+    beginInsertRows(indexForItem(parent), 0, description.entries.size() - 1);
+    for (const QDBusObjectDescription::Entry &entry : description.entries) {
+        QDBusItem *item = new QDBusItem(entry.type,
+                                        entry.type == PathItem ? entry.name + '/'_L1 : entry.name,
+                                        parent);
+        parent->children.append(item);
+
+        for (const QDBusObjectDescription::Member &member : entry.members) {
+            QDBusItem *child = new QDBusItem(member.type, member.name, item);
+            switch (member.type) {
+            case MethodItem:
+                child->caption = tr("Method: %1").arg(member.name);
+                child->typeSignature = member.typeSignature;
+                break;
+            case SignalItem:
+                child->caption = tr("Signal: %1").arg(member.name);
+                break;
+            case PropertyItem:
+                child->caption = tr("Property: %1").arg(member.name);
+                break;
+            default:
+                break;
+            }
+            item->children.append(child);
+        }
+    }
+    endInsertRows();
+}
+
+QDBusItem *QDBusModel::findPathItem(const QString &path) const
+{
+    const QStringList branches = path.split('/'_L1, Qt::SkipEmptyParts);
+
+    QDBusItem *item = root;
+    for (const QString &branch : branches) {
+        const auto it = std::find_if(item->children.cbegin(), item->children.cend(),
+                                     [&branch](const QDBusItem *child) {
+                                         return child->type == PathItem
+                                                 && child->name.size() == branch.size() + 1
+                                                 && child->name.startsWith(branch);
+                                     });
+        if (it == item->children.cend())
+            return nullptr;
+        item = *it;
+    }
+    return item;
+}
+
+QModelIndex QDBusModel::indexForItem(QDBusItem *item) const
+{
+    if (!item || !item->parent)
+        return QModelIndex();
+    return createIndex(item->parent->children.indexOf(item), 0, item);
 }
 
-QDBusModel::QDBusModel(const QString &aService, const QDBusConnection &connection)
-    : service(aService), c(connection), root(0)
+QDBusModel::QDBusModel(const QString &aService, QDBusObjectCache *aCache)
+    : service(aService), cache(aCache), root(0)
 {
     root = new QDBusItem(QDBusModel::PathItem, "/"_L1);
+    connect(cache, &QDBusObjectCache::introspected, this, &QDBusModel::objectIntrospected);
+    connect(cache, &QDBusObjectCache::introspectionFailed, this,
+            &QDBusModel::introspectionFailed);
+    connect(cache, &QDBusObjectCache::introspectionCanceled, this,
+            &QDBusModel::introspectionCanceled);
 }
 
 QDBusModel::~QDBusModel()
@@ -184,8 +433,6 @@ int QDBusModel::rowCount(const QModelIndex &parent) const
     QDBusItem *item = static_cast<QDBusItem *>(parent.internalPointer());
     if (!item)
         item = root;
-    if (!item->isPrefetched)
-        const_cast<QDBusModel *>(this)->addPath(item);
 
     return item->children.size();
 }
@@ -195,6 +442,34 @@ int QDBusModel::columnCount(const QModelIndex &) const
     return 1;
 }
 
+bool QDBusModel::hasChildren(const QModelIndex &parent) const
+{
+    const QDBusItem *item = static_cast<QDBusItem *>(parent.internalPointer());
+    if (!item)
+        item = root;
+
+    // Paths are introspected when expanded, assume they have children until then
+    return !item->isPrefetched || !item->children.isEmpty();
+}
+
+bool QDBusModel::canFetchMore(const QModelIndex &parent) const
+{
+    const QDBusItem *item = static_cast<QDBusItem *>(parent.internalPointer());
+    if (!item)
+        item = root;
+
+    return !item->isPrefetched && !item->isFetching;
+}
+
+void QDBusModel::fetchMore(const QModelIndex &parent)
+{
+    QDBusItem *item = static_cast<QDBusItem *>(parent.internalPointer());
+    if (!item)
+        item = root;
+
+    fetchPath(item);
+}
+
 QVariant QDBusModel::data(const QModelIndex &index, int role) const
 {
     const QDBusItem *item = static_cast<QDBusItem *>(index.internalPointer());
@@ -239,11 +514,10 @@ void QDBusModel::refresh(const QModelIndex &aIndex)
         endRemoveRows();
     }
 
-    addPath(item);
-    if (!item->children.isEmpty()) {
-        beginInsertRows(index, 0, item->children.size() - 1);
-        endInsertRows();
-    }
+    item->isPrefetched = false;
+    item->isFetching = false;
+    cache->invalidate(service, item->path());
+    fetchPath(item);
 }
 
 QString QDBusModel::dBusPath(const QModelIndex &aIndex) const
@@ -288,6 +562,11 @@ QModelIndex QDBusModel::findObject(const QDBusObjectPath &objectPath)
 {
     QStringList path = objectPath.path().split('/'_L1, Qt::SkipEmptyParts);
 
+    if (!root->isPrefetched) {
+        fetchPath(root);
+        cache->waitForFetch(service, root->path());
+    }
+
     QDBusItem *item = root;
     int childIdx = -1;
     while (item && !path.isEmpty()) {
@@ -301,9 +580,11 @@ QModelIndex QDBusModel::findObject(const QDBusObjectPath &objectPath)
                 item = child;
                 childIdx = i;
 
-                // prefetch the found branch
-                if (!item->isPrefetched)
-                    addPath(item);
+                // fetch the found branch, waiting for it if needed
+                if (!item->isPrefetched) {
+                    fetchPath(item);
+                    cache->waitForFetch(service, item->path());
+                }
                 break;
             }
         }
@@ -5,13 +5,15 @@
 #define QDBUSMODEL_H
 
 #include <QtCore/qabstractitemmodel.h>
+#include <QtCore/qhash.h>
 #include <QtDBus/QDBusConnection>
 
 struct QDBusItem;
+struct QDBusObjectDescription;
+class QDBusObjectCache;
 
-QT_FORWARD_DECLARE_CLASS(QDomDocument);
-QT_FORWARD_DECLARE_CLASS(QDomElement);
 QT_FORWARD_DECLARE_CLASS(QDBusObjectPath)
+QT_FORWARD_DECLARE_CLASS(QDBusPendingCallWatcher)
 
 
 class QDBusModel: public QAbstractItemModel
@@ -21,7 +23,7 @@ class QDBusModel: public QAbstractItemModel
 public:
     enum Type { InterfaceItem, PathItem, MethodItem, SignalItem, PropertyItem };
 
-    QDBusModel(const QString &service, const QDBusConnection &connection);
+    QDBusModel(const QString &service, QDBusObjectCache *cache);
     ~QDBusModel();
 
 
@@ -29,6 +31,9 @@ public:
     QModelIndex parent(const QModelIndex &child) const override;
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
 
@@ -46,14 +51,77 @@ Q_SIGNALS:
     void busError(const QString &text);
 
 private:
-    QDomDocument introspect(const QString &path);
-    void addMethods(QDBusItem *parent, const QDomElement &iface);
-    void addPath(QDBusItem *parent);
+    void objectIntrospected(const QString &service, const QString &path);
+    void introspectionFailed(const QString &service, const QString &path, const QDBusError &error);
+    void introspectionCanceled(const QString &service, const QString &path);
+    void fetchPath(QDBusItem *item);
+    void addPath(QDBusItem *parent, const QDBusObjectDescription &description);
+    QDBusItem *findPathItem(const QString &path) const;
+    QModelIndex indexForItem(QDBusItem *item) const;
 
     QString service;
-    QDBusConnection c;
+    QDBusObjectCache *cache;
     QDBusItem *root;
 };
 
+// Introspection data of an object: Its child objects and interfaces
+struct QDBusObjectDescription
+{
+    struct Member
+    {
+        QDBusModel::Type type;
+        QString name;
+        QString typeSignature;
+    };
+
+    struct Entry
+    {
+        QDBusModel::Type type; // PathItem or InterfaceItem
+        QString name;
+        QList<Member> members;
+    };
+
+    QList<Entry> entries;
+};
+
+// Introspects objects asynchronously and keeps the results until the owner
+// of the service changes, so that switching back and forth between services
+// does not introspect them again.
+class QDBusObjectCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit QDBusObjectCache(const QDBusConnection &connection, QObject *parent = nullptr);
+
+    const QDBusObjectDescription *description(const QString &service, const QString &path) const;
+    const QDBusObjectDescription *fetch(const QString &service, const QString &path);
+    void waitForFetch(const QString &service, const QString &path);
+    // Forgets the object at path and all objects below it, or the whole service
+    void invalidate(const QString &service, const QString &path = QString());
+
+Q_SIGNALS:
+    void introspected(const QString &service, const QString &path);
+    void introspectionFailed(const QString &service, const QString &path, const QDBusError &error);
+    void introspectionCanceled(const QString &service, const QString &path);
+
+private:
+    struct PendingIntrospection
+    {
+        QDBusPendingCallWatcher *watcher = nullptr;
+        bool prefetchChildren = false;
+    };
+
+    void introspect(const QString &service, const QString &path, bool prefetchChildren);
+    void introspectionFinished(const QString &service, const QString &path,
+                               QDBusPendingCallWatcher *watcher);
+    void prefetchChildren(const QString &service, const QString &path,
+                          const QDBusObjectDescription &description);
+
+    QDBusConnection c;
+    QHash<QString, QHash<QString, QDBusObjectDescription>> descriptions;
+    QHash<QString, QHash<QString, PendingIntrospection>> pending;
+};
+
 #endif
 
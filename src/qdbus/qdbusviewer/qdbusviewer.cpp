@@ -37,8 +37,8 @@ using namespace Qt::StringLiterals;
 class QDBusViewModel: public QDBusModel
 {
 public:
-    inline QDBusViewModel(const QString &service, const QDBusConnection &connection)
-        : QDBusModel(service, connection)
+    inline QDBusViewModel(const QString &service, QDBusObjectCache *cache)
+        : QDBusModel(service, cache)
     {}
 
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override
@@ -68,6 +68,8 @@ public:
 QDBusViewer::QDBusViewer(const QDBusConnection &connection, QWidget *parent)
     : QWidget(parent), c(connection), objectPathRegExp("\\[ObjectPath: (.*)\\]"_L1)
 {
+    objectCache = new QDBusObjectCache(c, this);
+
     serviceFilterLine = new QLineEdit(this);
     serviceFilterLine->setPlaceholderText(tr("Search..."));
 
@@ -487,7 +489,7 @@ void QDBusViewer::serviceChanged(const QModelIndex &index)
         return;
     currentService = index.data().toString();
 
-    QDBusViewModel *model = new QDBusViewModel(currentService, c);
+    QDBusViewModel *model = new QDBusViewModel(currentService, objectCache);
     tree->setModel(model);
     connect(model, &QDBusModel::busError, this, &QDBusViewer::logError);
 }
@@ -513,6 +515,11 @@ static QModelIndex findItem(QStringListModel *servicesModel, const QString &name
 void QDBusViewer::serviceOwnerChanged(const QString &name, const QString &oldOwner,
                                       const QString &newOwner)
 {
+    // Whatever was introspected belonged to the previous owner
+    objectCache->invalidate(name);
+    if (!oldOwner.isEmpty())
+        objectCache->invalidate(oldOwner);
+
     QModelIndex hit = findItem(servicesModel, name);
 
     if (!hit.isValid() && oldOwner.isEmpty() && !newOwner.isEmpty())
@@ -9,6 +9,7 @@
 #include <QtCore/QRegularExpression>
 
 class ServicesProxyModel;
+class QDBusObjectCache;
 
 QT_FORWARD_DECLARE_CLASS(QTableView)
 QT_FORWARD_DECLARE_CLASS(QTreeView)
@@ -65,6 +66,7 @@ private:
     bool eventFilter(QObject *obj, QEvent *event) override;
 
     QDBusConnection c;
+    QDBusObjectCache *objectCache;
     QString currentService;
     QTreeView *tree;
     QAction *refreshAction;
@@ -53,6 +53,10 @@ int main(int argc, char *argv[])
     QCommandLineOption outputOption({ u"o"_s, u"output"_s },
                                     tr("Write generated data to <file>."),
                                     u"file"_s);
+    QCommandLineOption cacheOption(u"cache"_s,
+                                   tr("Keep the results in <file> and reuse them for attribution "
+                                      "files that did not change."),
+                                   u"file"_s);
     QCommandLineOption verboseOption(u"verbose"_s, tr("Verbose output."));
     QCommandLineOption silentOption({ u"s"_s, u"silent"_s }, tr("Minimal output."));
 
@@ -62,6 +66,7 @@ int main(int argc, char *argv[])
     parser.addOption(baseDirOption);
     parser.addOption(noCheckPathsOption);
     parser.addOption(outputOption);
+    parser.addOption(cacheOption);
     parser.addOption(verboseOption);
     parser.addOption(silentOption);
 
@@ -100,6 +105,13 @@ int main(int argc, char *argv[])
         parser.showHelp(8);
     }
 
+    const QString cacheFilePath = parser.value(cacheOption);
+    if (!cacheFilePath.isEmpty() && !Scanner::loadCache(cacheFilePath, checks, logLevel)
+        && logLevel == VerboseLog) {
+        std::cerr << qPrintable(tr("Ignoring outdated or unreadable cache %1.").arg(
+                                    QDir::toNativeSeparators(cacheFilePath))) << std::endl;
+    }
+
     // Parse the attribution files
     QList<Package> packages;
     for (const QString &path: paths) {
@@ -126,6 +138,11 @@ int main(int argc, char *argv[])
         }
     }
 
+    if (!cacheFilePath.isEmpty() && !Scanner::saveCache(cacheFilePath, checks, logLevel)) {
+        std::cerr << qPrintable(tr("Cannot write cache %1.").arg(
+                                    QDir::toNativeSeparators(cacheFilePath))) << std::endl;
+    }
+
     // Apply the filter
     if (parser.isSet(filterOption)) {
         PackageFilter filter(parser.value(filterOption));
@@ -4,23 +4,151 @@
 #include "scanner.h"
 #include "logging.h"
 
+#include <QtCore/qdatastream.h>
+#include <QtCore/qdatetime.h>
 #include <QtCore/qdir.h>
 #include <QtCore/qhash.h>
 #include <QtCore/qjsonarray.h>
 #include <QtCore/qjsondocument.h>
 #include <QtCore/qjsonobject.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qsavefile.h>
 #include <QtCore/qtextstream.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/qtimezone.h>
 #include <QtCore/qvariant.h>
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <utility>
+#include <vector>
 
 using namespace Qt::Literals::StringLiterals;
 
+static QDataStream &operator<<(QDataStream &out, const Package &p)
+{
+    return out << p.id << p.path << p.files << p.name << p.qdocModule << p.qtUsage
+               << p.securityCritical << p.qtParts << p.description << p.homepage << p.version
+               << p.downloadLocation << p.license << p.licenseId << p.licenseFiles
+               << p.licenseFilesContents << p.copyright << p.copyrightFile
+               << p.copyrightFileContents << p.cpeList << p.purlList << p.packageComment;
+}
+
+static QDataStream &operator>>(QDataStream &in, Package &p)
+{
+    return in >> p.id >> p.path >> p.files >> p.name >> p.qdocModule >> p.qtUsage
+              >> p.securityCritical >> p.qtParts >> p.description >> p.homepage >> p.version
+              >> p.downloadLocation >> p.license >> p.licenseId >> p.licenseFiles
+              >> p.licenseFilesContents >> p.copyright >> p.copyrightFile
+              >> p.copyrightFileContents >> p.cpeList >> p.purlList >> p.packageComment;
+}
+
 namespace Scanner {
 
+// State of reading one attribution file: The diagnostics are collected so that
+// files can be read on worker threads and still be reported in scan order, the
+// files looked at decide whether a cached result is still valid.
+struct ReadContext
+{
+    std::ostringstream diagnostics;
+    QStringList dependencies;
+};
+
+static thread_local ReadContext *currentReadContext = nullptr;
+
+static std::ostream &diagOut()
+{
+    return currentReadContext ? currentReadContext->diagnostics : std::cerr;
+}
+
+static void addDependency(const QString &path)
+{
+    if (currentReadContext)
+        currentReadContext->dependencies.append(path);
+}
+
+// Modification time in ms since the epoch, or -1 if the file does not exist
+static qint64 modificationTime(const QString &path)
+{
+    const QFileInfo info(path);
+    return info.exists() ? info.lastModified(QTimeZone::UTC).toMSecsSinceEpoch() : -1;
+}
+
+// License and copyright files are shared by many packages, read each of them only once
+static std::optional<QString> readTextFile(const QString &filePath)
+{
+    static QMutex mutex;
+    static QHash<QString, std::optional<QString>> contents;
+
+    addDependency(filePath);
+    QMutexLocker locker(&mutex);
+    const auto it = contents.constFind(filePath);
+    if (it != contents.cend())
+        return *it;
+    locker.unlock();
+
+    std::optional<QString> result;
+    QFile file(filePath);
+    if (file.open(QIODevice::ReadOnly))
+        result = QString::fromUtf8(file.readAll());
+
+    locker.relock();
+    contents.insert(filePath, result);
+    return result;
+}
+
+struct CacheEntry
+{
+    QList<std::pair<QString, qint64>> dependencies; // path and modification time
+    QByteArray diagnostics;
+    bool ok = false;
+    QList<Package> packages;
+};
+
+static QDataStream &operator<<(QDataStream &out, const CacheEntry &entry)
+{
+    out << entry.dependencies << entry.diagnostics << entry.ok << qint64(entry.packages.size());
+    for (const Package &p : entry.packages)
+        out << p;
+    return out;
+}
+
+static QDataStream &operator>>(QDataStream &in, CacheEntry &entry)
+{
+    qint64 count = 0;
+    in >> entry.dependencies >> entry.diagnostics >> entry.ok >> count;
+    entry.packages.clear();
+    for (qint64 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        Package p;
+        in >> p;
+        entry.packages.append(p);
+    }
+    return in;
+}
+
+// Results of reading attribution files, see loadCache()
+struct ResultCache
+{
+    QMutex mutex;
+    bool enabled = false;
+    QHash<QString, CacheEntry> previous; // loaded from the cache file
+    QHash<QString, CacheEntry> current; // used in this run, to be saved
+};
+
+static ResultCache &resultCache()
+{
+    static ResultCache cache;
+    return cache;
+}
+
+static const quint32 cacheMagic = 0x51744153; // "QtAS"
+static const quint32 cacheVersion = 1;
+
 static void missingPropertyWarning(const QString &filePath, const QString &property)
 {
-    std::cerr << qPrintable(tr("File %1: Missing mandatory property '%2'.").arg(
+    diagOut() << qPrintable(tr("File %1: Missing mandatory property '%2'.").arg(
                                 QDir::toNativeSeparators(filePath), property)) << std::endl;
 }
 
@@ -53,7 +181,7 @@ static bool validatePackage(Package &p, const QString &filePath, Checks checks,
 
     if (!p.copyright.isEmpty() && !p.copyrightFile.isEmpty()) {
         if (logLevel != SilentLog) {
-            std::cerr << qPrintable(tr("File %1: Properties 'Copyright' and 'CopyrightFile' are "
+            diagOut() << qPrintable(tr("File %1: Properties 'Copyright' and 'CopyrightFile' are "
                                        "mutually exclusive.")
                                             .arg(QDir::toNativeSeparators(filePath)))
                       << std::endl;
@@ -72,7 +200,7 @@ static bool validatePackage(Package &p, const QString &filePath, Checks checks,
             && part != "tools"_L1 && part != "libs"_L1) {
 
             if (logLevel != SilentLog) {
-                std::cerr << qPrintable(tr("File %1: Property 'QtPart' contains unknown element "
+                diagOut() << qPrintable(tr("File %1: Property 'QtPart' contains unknown element "
                                            "'%2'. Valid entries are 'examples', 'tests', 'tools' "
                                            "and 'libs'.").arg(
                                             QDir::toNativeSeparators(filePath), part))
@@ -86,17 +214,19 @@ static bool validatePackage(Package &p, const QString &filePath, Checks checks,
         return validPackage;
 
     const QDir dir = p.path;
+    addDependency(p.path);
     if (!dir.exists()) {
-        std::cerr << qPrintable(
+        diagOut() << qPrintable(
                 tr("File %1: Directory '%2' does not exist.")
                         .arg(QDir::toNativeSeparators(filePath), QDir::toNativeSeparators(p.path)))
                   << std::endl;
         validPackage = false;
     } else {
         for (const QString &file : std::as_const(p.files)) {
+            addDependency(dir.filePath(file));
             if (!dir.exists(file)) {
                 if (logLevel != SilentLog) {
-                    std::cerr << qPrintable(
+                    diagOut() << qPrintable(
                             tr("File %1: Path '%2' does not exist in directory '%3'.")
                                     .arg(QDir::toNativeSeparators(filePath),
                                          QDir::toNativeSeparators(file),
@@ -191,7 +321,7 @@ static bool autoDetectLicenseFiles(Package &p)
     const QString licensesDirPath = locateLicensesDir(p.path);
     const QStringList licenseIds = extractLicenseIdsFromSPDXExpression(p.licenseId);
     if (!licenseIds.isEmpty() && licensesDirPath.isEmpty()) {
-        std::cerr << qPrintable(tr("LICENSES directory could not be located.")) << std::endl;
+        diagOut() << qPrintable(tr("LICENSES directory could not be located.")) << std::endl;
         return false;
     }
 
@@ -199,10 +329,11 @@ static bool autoDetectLicenseFiles(Package &p)
     QDir licensesDir(licensesDirPath);
     for (const QString &id : licenseIds) {
         QString fileName = id + u".txt";
+        addDependency(licensesDir.filePath(fileName));
         if (licensesDir.exists(fileName)) {
             p.licenseFiles.append(licensesDir.filePath(fileName));
         } else {
-            std::cerr << qPrintable(tr("Expected license file not found: %1").arg(
+            diagOut() << qPrintable(tr("Expected license file not found: %1").arg(
                                         QDir::toNativeSeparators(licensesDir.filePath(fileName))))
                       << std::endl;
             success = false;
@@ -227,7 +358,7 @@ static bool handleStringOrStringArrayJsonKey(QStringList &outList, const QString
         outList.append(jsonValue.toString());
     } else {
         if (logLevel != SilentLog) {
-            std::cerr << qPrintable(tr("File %1: Expected JSON array of strings or "
+            diagOut() << qPrintable(tr("File %1: Expected JSON array of strings or "
                                        "string as value of %2.").arg(
                                         QDir::toNativeSeparators(filePath), key))
                       << std::endl;
@@ -253,7 +384,7 @@ static std::optional<Package> readPackage(const QJsonObject &object, const QStri
             && key != "Files"_L1 && key != "LicenseFiles"_L1 && key != "Comment"_L1
             && key != "Copyright"_L1 && key != "CPE"_L1 && key != "PURL"_L1) {
             if (logLevel != SilentLog)
-                std::cerr << qPrintable(tr("File %1: Expected JSON string as value of %2.").arg(
+                diagOut() << qPrintable(tr("File %1: Expected JSON string as value of %2.").arg(
                                             QDir::toNativeSeparators(filePath), key)) << std::endl;
             validPackage = false;
             continue;
@@ -274,7 +405,7 @@ static std::optional<Package> readPackage(const QJsonObject &object, const QStri
                 p.files = value.simplified().split(QLatin1Char(' '), Qt::SkipEmptyParts);
             } else {
                 if (logLevel != SilentLog) {
-                    std::cerr << qPrintable(tr("File %1: Expected JSON array of strings as value "
+                    diagOut() << qPrintable(tr("File %1: Expected JSON array of strings as value "
                                                "of Files."));
                     validPackage = false;
                     continue;
@@ -303,7 +434,7 @@ static std::optional<Package> readPackage(const QJsonObject &object, const QStri
             auto strings = toStringList(iter.value());
             if (!strings) {
                 if (logLevel != SilentLog)
-                    std::cerr << qPrintable(tr("File %1: Expected JSON array of strings in %2.")
+                    diagOut() << qPrintable(tr("File %1: Expected JSON array of strings in %2.")
                                                     .arg(QDir::toNativeSeparators(filePath), key))
                               << std::endl;
                 validPackage = false;
@@ -324,7 +455,7 @@ static std::optional<Package> readPackage(const QJsonObject &object, const QStri
                 p.copyright = value;
             } else {
                 if (logLevel != SilentLog) {
-                    std::cerr << qPrintable(tr("File %1: Expected JSON array of strings or "
+                    diagOut() << qPrintable(tr("File %1: Expected JSON array of strings or "
                                                "string as value of %2.").arg(
                                                 QDir::toNativeSeparators(filePath), key)) << std::endl;
                     validPackage = false;
@@ -355,7 +486,7 @@ static std::optional<Package> readPackage(const QJsonObject &object, const QStri
             p.qtUsage = value;
         } else if (key == "SecurityCritical"_L1) {
             if (!iter.value().isBool()) {
-                std::cerr << qPrintable(tr("File %1: Expected JSON boolean in %2.")
+                diagOut() << qPrintable(tr("File %1: Expected JSON boolean in %2.")
                                                 .arg(QDir::toNativeSeparators(filePath), key))
                           << std::endl;
                 validPackage = false;
@@ -366,7 +497,7 @@ static std::optional<Package> readPackage(const QJsonObject &object, const QStri
             auto parts = toStringList(iter.value());
             if (!parts) {
                 if (logLevel != SilentLog) {
-                    std::cerr << qPrintable(tr("File %1: Expected JSON array of strings in %2.")
+                    diagOut() << qPrintable(tr("File %1: Expected JSON array of strings in %2.")
                                                     .arg(QDir::toNativeSeparators(filePath), key))
                               << std::endl;
                 }
@@ -376,7 +507,7 @@ static std::optional<Package> readPackage(const QJsonObject &object, const QStri
             p.qtParts = parts.value();
         } else {
             if (logLevel != SilentLog) {
-                std::cerr << qPrintable(tr("File %1: Unknown key %2.").arg(
+                diagOut() << qPrintable(tr("File %1: Unknown key %2.").arg(
                                             QDir::toNativeSeparators(filePath), key)) << std::endl;
             }
             validPackage = false;
@@ -384,30 +515,30 @@ static std::optional<Package> readPackage(const QJsonObject &object, const QStri
     }
 
     if (!p.copyrightFile.isEmpty()) {
-        QFile file(p.copyrightFile);
-        if (!file.open(QIODevice::ReadOnly)) {
-            std::cerr << qPrintable(tr("File %1: Cannot open 'CopyrightFile' %2.\n")
+        const std::optional<QString> contents = readTextFile(p.copyrightFile);
+        if (!contents) {
+            diagOut() << qPrintable(tr("File %1: Cannot open 'CopyrightFile' %2.\n")
                                             .arg(QDir::toNativeSeparators(filePath),
                                                  QDir::toNativeSeparators(p.copyrightFile)));
             validPackage = false;
         }
-        p.copyrightFileContents = QString::fromUtf8(file.readAll());
+        p.copyrightFileContents = contents.value_or(QString());
     }
 
     if (p.licenseFiles.isEmpty() && !autoDetectLicenseFiles(p))
         return std::nullopt;
 
     for (const QString &licenseFile : std::as_const(p.licenseFiles)) {
-        QFile file(licenseFile);
-        if (!file.open(QIODevice::ReadOnly)) {
+        const std::optional<QString> contents = readTextFile(licenseFile);
+        if (!contents) {
             if (logLevel != SilentLog) {
-                std::cerr << qPrintable(tr("File %1: Cannot open 'LicenseFile' %2.\n")
+                diagOut() << qPrintable(tr("File %1: Cannot open 'LicenseFile' %2.\n")
                                                 .arg(QDir::toNativeSeparators(filePath),
                                                      QDir::toNativeSeparators(licenseFile)));
             }
             validPackage = false;
         }
-        p.licenseFilesContents << QString::fromUtf8(file.readAll()).trimmed();
+        p.licenseFilesContents << contents.value_or(QString()).trimmed();
     }
 
     if (!validatePackage(p, filePath, checks, logLevel) || !validPackage)
@@ -477,6 +608,7 @@ static Package parseChromiumFile(QFile &file, const QString &filePath, LogLevel
     } else {
         // Look for a LICENSE or COPYING file as a fallback
         QDir dir = directory;
+        addDependency(directory);
 
         dir.setNameFilters({ u"LICENSE"_s, u"COPYING"_s });
         dir.setFilter(QDir::Files | QDir::NoDotAndDotDot);
@@ -492,19 +624,20 @@ static Package parseChromiumFile(QFile &file, const QString &filePath, LogLevel
     return p;
 }
 
-std::optional<QList<Package>> readFile(const QString &filePath, Checks checks, LogLevel logLevel)
+static std::optional<QList<Package>> readFileUncached(const QString &filePath, Checks checks,
+                                                      LogLevel logLevel)
 {
     QList<Package> packages;
     bool errorsFound = false;
 
     if (logLevel == VerboseLog) {
-        std::cerr << qPrintable(tr("Reading file %1...").arg(
+        diagOut() << qPrintable(tr("Reading file %1...").arg(
                                     QDir::toNativeSeparators(filePath))) << std::endl;
     }
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
         if (logLevel != SilentLog)
-            std::cerr << qPrintable(tr("Could not open file %1.").arg(
+            diagOut() << qPrintable(tr("Could not open file %1.").arg(
                                         QDir::toNativeSeparators(file.fileName()))) << std::endl;
         return std::nullopt;
     }
@@ -514,7 +647,7 @@ std::optional<QList<Package>> readFile(const QString &filePath, Checks checks, L
         const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &jsonParseError);
         if (document.isNull()) {
             if (logLevel != SilentLog)
-                std::cerr << qPrintable(tr("Could not parse file %1: %2").arg(
+                diagOut() << qPrintable(tr("Could not parse file %1: %2").arg(
                                             QDir::toNativeSeparators(file.fileName()),
                                             jsonParseError.errorString()))
                           << std::endl;
@@ -543,7 +676,7 @@ std::optional<QList<Package>> readFile(const QString &filePath, Checks checks, L
                     }
                 } else {
                     if (logLevel != SilentLog) {
-                        std::cerr << qPrintable(tr("File %1: Expecting JSON object in array.")
+                        diagOut() << qPrintable(tr("File %1: Expecting JSON object in array.")
                                         .arg(QDir::toNativeSeparators(file.fileName())))
                                   << std::endl;
                     }
@@ -552,7 +685,7 @@ std::optional<QList<Package>> readFile(const QString &filePath, Checks checks, L
             }
         } else {
             if (logLevel != SilentLog) {
-                std::cerr << qPrintable(tr("File %1: Expecting JSON object in array.").arg(
+                diagOut() << qPrintable(tr("File %1: Expecting JSON object in array.").arg(
                                             QDir::toNativeSeparators(file.fileName()))) << std::endl;
             }
             errorsFound = true;
@@ -563,7 +696,7 @@ std::optional<QList<Package>> readFile(const QString &filePath, Checks checks, L
             packages << chromiumPackage;
     } else {
         if (logLevel != SilentLog) {
-            std::cerr << qPrintable(tr("File %1: Unsupported file type.")
+            diagOut() << qPrintable(tr("File %1: Unsupported file type.")
                             .arg(QDir::toNativeSeparators(file.fileName())))
                       << std::endl;
         }
@@ -575,13 +708,168 @@ std::optional<QList<Package>> readFile(const QString &filePath, Checks checks, L
     return packages;
 }
 
-std::optional<QList<Package>> scanDirectory(const QString &directory, InputFormats inputFormats,
-                                            Checks checks, LogLevel logLevel)
+std::optional<QList<Package>> readFile(const QString &filePath, Checks checks, LogLevel logLevel)
 {
-    QDir dir(directory);
-    QList<Package> packages;
+    const QString absoluteFilePath = QFileInfo(filePath).absoluteFilePath();
+    ResultCache &cache = resultCache();
+    {
+        QMutexLocker locker(&cache.mutex);
+        const auto it = cache.enabled ? cache.previous.constFind(absoluteFilePath)
+                                      : cache.previous.cend();
+        if (it != cache.previous.cend()) {
+            const bool upToDate = std::all_of(it->dependencies.cbegin(), it->dependencies.cend(),
+                                              [](const std::pair<QString, qint64> &dependency) {
+                                                  return modificationTime(dependency.first)
+                                                          == dependency.second;
+                                              });
+            if (upToDate) {
+                const CacheEntry entry = cache.current[absoluteFilePath] = *it;
+                locker.unlock();
+                diagOut() << entry.diagnostics.toStdString() << std::flush;
+                if (!entry.ok)
+                    return std::nullopt;
+                return entry.packages;
+            }
+        }
+    }
+
+    ReadContext context;
+    context.dependencies.append(absoluteFilePath);
+    ReadContext *outerContext = std::exchange(currentReadContext, &context);
+    const std::optional<QList<Package>> result = readFileUncached(filePath, checks, logLevel);
+    currentReadContext = outerContext;
+
+    const std::string text = context.diagnostics.str();
+    diagOut() << text << std::flush;
+
+    QMutexLocker locker(&cache.mutex);
+    if (cache.enabled) {
+        CacheEntry &entry = cache.current[absoluteFilePath];
+        entry.dependencies.clear();
+        for (const QString &dependency : std::as_const(context.dependencies))
+            entry.dependencies.append({ dependency, modificationTime(dependency) });
+        entry.diagnostics = QByteArray::fromStdString(text);
+        entry.ok = result.has_value();
+        entry.packages = result.value_or(QList<Package>());
+    }
+    return result;
+}
+
+bool loadCache(const QString &cacheFilePath, Checks checks, LogLevel logLevel)
+{
+    ResultCache &cache = resultCache();
+    QMutexLocker locker(&cache.mutex);
+    cache.enabled = true;
+    cache.previous.clear();
+
+    QFile file(cacheFilePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return !file.exists();
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    int storedChecks = 0;
+    int storedLogLevel = 0;
+    in >> magic >> version >> storedChecks >> storedLogLevel;
+    if (magic != cacheMagic || version != cacheVersion || storedChecks != checks.toInt()
+        || storedLogLevel != logLevel) {
+        return false; // start over
+    }
+    in >> cache.previous;
+    if (in.status() != QDataStream::Ok) {
+        cache.previous.clear();
+        return false;
+    }
+    return true;
+}
+
+bool saveCache(const QString &cacheFilePath, Checks checks, LogLevel logLevel)
+{
+    ResultCache &cache = resultCache();
+    QMutexLocker locker(&cache.mutex);
+
+    QSaveFile file(cacheFilePath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << cacheMagic << cacheVersion << checks.toInt() << int(logLevel) << cache.current;
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+namespace {
+
+// An entry of a directory being scanned. Subdirectories are scanned and files
+// read in parallel, the results are collected in the original order afterwards.
+struct ScanNode
+{
+    QString path;
+    bool isDir = false;
+    std::vector<std::unique_ptr<ScanNode>> children;
+    std::optional<QList<Package>> packages;
+    std::string diagnostics;
+};
+
+struct ScanOptions
+{
+    QStringList nameFilters;
+    Checks checks;
+    LogLevel logLevel;
+    QThreadPool *pool;
+};
+
+} // unnamed namespace
+
+static void scanNode(ScanNode *node, const ScanOptions &options)
+{
+    if (!node->isDir) {
+        ReadContext context;
+        currentReadContext = &context;
+        node->packages = readFile(node->path, options.checks, options.logLevel);
+        currentReadContext = nullptr;
+        node->diagnostics = context.diagnostics.str();
+        return;
+    }
+
+    QDir dir(node->path);
+    dir.setNameFilters(options.nameFilters);
+    dir.setFilter(QDir::AllDirs | QDir::NoDotAndDotDot | QDir::Files);
+
+    const QFileInfoList entries = dir.entryInfoList();
+    node->children.reserve(entries.size());
+    for (const QFileInfo &info : entries) {
+        auto child = std::make_unique<ScanNode>();
+        child->path = info.filePath();
+        child->isDir = info.isDir();
+        ScanNode *childNode = child.get();
+        node->children.push_back(std::move(child));
+        options.pool->start([childNode, &options] { scanNode(childNode, options); });
+    }
+}
+
+static bool collectPackages(const ScanNode &node, QList<Package> *packages)
+{
+    if (!node.isDir) {
+        std::cerr << node.diagnostics << std::flush;
+        if (!node.packages)
+            return false;
+        *packages += *node.packages;
+        return true;
+    }
+
     bool errorsFound = false;
+    for (const auto &child : node.children) {
+        if (!collectPackages(*child, packages))
+            errorsFound = true;
+    }
+    return !errorsFound;
+}
 
+std::optional<QList<Package>> scanDirectory(const QString &directory, InputFormats inputFormats,
+                                            Checks checks, LogLevel logLevel)
+{
     QStringList nameFilters = QStringList();
     if (inputFormats & InputFormat::QtAttributions)
         nameFilters << u"qt_attribution.json"_s;
@@ -590,28 +878,16 @@ std::optional<QList<Package>> scanDirectory(const QString &directory, InputForma
     if (qEnvironmentVariableIsSet("QT_ATTRIBUTIONSSCANNER_TEST"))
         nameFilters << u"qt_attribution_test.json"_s << u"README_test.chromium"_s;
 
-    dir.setNameFilters(nameFilters);
-    dir.setFilter(QDir::AllDirs | QDir::NoDotAndDotDot | QDir::Files);
-
-    const QFileInfoList entries = dir.entryInfoList();
-    for (const QFileInfo &info : entries) {
-        if (info.isDir()) {
-            std::optional<QList<Package>> ps =
-                    scanDirectory(info.filePath(), inputFormats, checks, logLevel);
-            if (!ps)
-                errorsFound = true;
-            else
-                packages += *ps;
-        } else {
-            std::optional p = readFile(info.filePath(), checks, logLevel);
-            if (!p)
-                errorsFound = true;
-            else
-                packages += *p;
-        }
-    }
+    QThreadPool pool;
+    const ScanOptions options{ nameFilters, checks, logLevel, &pool };
+    ScanNode root;
+    root.path = directory;
+    root.isDir = true;
+    pool.start([&root, &options] { scanNode(&root, options); });
+    pool.waitForDone();
 
-    if (errorsFound)
+    QList<Package> packages;
+    if (!collectPackages(root, &packages))
         return std::nullopt;
     return packages;
 }
@@ -28,6 +28,11 @@ Q_DECLARE_OPERATORS_FOR_FLAGS(Checks)
 std::optional<QList<Package>> readFile(const QString &filePath, Checks checks, LogLevel logLevel);
 std::optional<QList<Package>> scanDirectory(const QString &directory, InputFormats inputFormats,
                                             Checks checks, LogLevel logLevel);
+
+// Results of reading attribution files can be kept in a cache file. They are
+// reused as long as none of the files that were looked at changed.
+bool loadCache(const QString &cacheFilePath, Checks checks, LogLevel logLevel);
+bool saveCache(const QString &cacheFilePath, Checks checks, LogLevel logLevel);
 }
 
 #endif // SCANNER_H
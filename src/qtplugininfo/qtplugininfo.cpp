@@ -5,12 +5,15 @@
 #include <QCommandLineParser>
 #include <QCoreApplication>
 #include <QDir>
+#include <QDirIterator>
 #include <QFile>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QLibrary>
 #include <QPluginLoader>
+#include <QSet>
 #include <QStringList>
+#include <QThreadPool>
 
 #include <iostream>
 
@@ -23,6 +26,97 @@ enum PrintOption {
 Q_DECLARE_FLAGS(PrintOptions, PrintOption)
 Q_DECLARE_OPERATORS_FOR_FLAGS(PrintOptions)
 
+struct PluginFile
+{
+    QString path;
+    bool fromDirectory = false; // found while scanning a directory, not named explicitly
+};
+
+struct PluginInfo
+{
+    QJsonObject metaData;
+    QString error;
+    bool skipped = false;
+};
+
+// Collects the plug-ins named on the command line, descending into directories.
+static QList<PluginFile> collectPlugins(const QStringList &arguments)
+{
+    QList<PluginFile> plugins;
+    QSet<QString> seen;
+    for (const QString &argument : arguments) {
+        if (!QFileInfo(argument).isDir()) {
+            plugins.append({ argument, false });
+            continue;
+        }
+
+        QStringList files;
+        QDirIterator it(argument, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            const QString file = it.next();
+            if (QLibrary::isLibrary(file) && !seen.contains(it.fileInfo().canonicalFilePath())) {
+                seen.insert(it.fileInfo().canonicalFilePath());
+                files.append(file);
+            }
+        }
+        files.sort();
+        for (const QString &file : std::as_const(files))
+            plugins.append({ file, true });
+    }
+    return plugins;
+}
+
+// Reads and validates the meta-data of one plug-in. QPluginLoader reads the
+// meta-data section from the file without loading the library, so this is
+// safe to run for many plug-ins in parallel.
+static PluginInfo readPlugin(const PluginFile &plugin)
+{
+    PluginInfo info;
+    if (!QFile::exists(plugin.path)) {
+        info.error = QStringLiteral("No such file or directory.");
+        return info;
+    }
+    if (!QLibrary::isLibrary(plugin.path)) {
+        info.error = QStringLiteral("Not a plug-in.");
+        return info;
+    }
+
+    QPluginLoader loader(plugin.path);
+    QJsonObject metaData = loader.metaData();
+    if (metaData.isEmpty()) {
+        // Plug-in directories may contain helper libraries as well
+        if (plugin.fromDirectory)
+            info.skipped = true;
+        else
+            info.error = QStringLiteral("No plug-in meta-data found: ") + loader.errorString();
+        return info;
+    }
+
+    QString iid = metaData.value("IID").toString();
+    QString className = metaData.value("className").toString();
+    QJsonValue debug = metaData.value("debug");
+    int version = metaData.value("version").toInt();
+
+    if ((version >> 16) != (QT_VERSION >> 16)) {
+        info.error = QStringLiteral("Qt version mismatch - got major version %1, expected %2")
+                .arg(version >> 16).arg(QT_VERSION >> 16);
+        return info;
+    }
+    if (iid.isEmpty() || className.isEmpty() || debug.isNull()) {
+        info.error = QStringLiteral("invalid metadata, missing required fields:");
+        if (iid.isEmpty())
+            info.error += QStringLiteral(" iid");
+        if (className.isEmpty())
+            info.error += QStringLiteral(" className");
+        if (debug.isNull())
+            info.error += QStringLiteral(" debug");
+        return info;
+    }
+
+    info.metaData = metaData;
+    return info;
+}
+
 int main(int argc, char** argv)
 {
     QCoreApplication app(argc, argv);
@@ -35,23 +129,27 @@ int main(int argc, char** argv)
                                         QStringLiteral("Print JSON data as: indented, compact"), QStringLiteral("format"));
     QCommandLineOption fullJsonOption("full-json",
                                       QStringLiteral("Print the plugin metadata in JSON format"));
+    QCommandLineOption combinedJsonOption("combined-json",
+                                          QStringLiteral("Print the metadata of all plug-ins as one JSON object, keyed by file name"));
     QCommandLineOption printOption(QStringList() << "p" << QStringLiteral("print"),
                                    QStringLiteral("Print detail (iid, classname, qtinfo, userdata)"), QStringLiteral("detail"));
     jsonFormatOption.setDefaultValue(QStringLiteral("indented"));
     printOption.setDefaultValues(QStringList() << QStringLiteral("iid") << QStringLiteral("qtinfo") << QStringLiteral("userdata"));
 
     parser.addOption(fullJsonOption);
+    parser.addOption(combinedJsonOption);
     parser.addOption(jsonFormatOption);
     parser.addOption(printOption);
     parser.addHelpOption();
     parser.addVersionOption();
-    parser.addPositionalArgument(QStringLiteral("plugin"), QStringLiteral("Plug-in of which to read the meta data."), QStringLiteral("<plugin>"));
+    parser.addPositionalArgument(QStringLiteral("plugin"), QStringLiteral("Plug-in of which to read the meta data, or a directory to search for plug-ins recursively."), QStringLiteral("<plugin>"));
     parser.process(app);
 
     if (parser.positionalArguments().isEmpty())
         parser.showHelp(1);
 
     bool fullJson = parser.isSet(fullJsonOption);
+    bool combinedJson = parser.isSet(combinedJsonOption);
     QJsonDocument::JsonFormat jsonFormat = parser.value(jsonFormatOption) == "indented" ? QJsonDocument::Indented : QJsonDocument::Compact;
     QStringList printOptionList = parser.values(printOption);
     PrintOptions print;
@@ -64,27 +162,38 @@ int main(int argc, char** argv)
     if (printOptionList.contains("userdata"))
         print |= PrintUserData;
 
+    const QList<PluginFile> plugins = collectPlugins(parser.positionalArguments());
+    QList<PluginInfo> infos(plugins.size());
+    {
+        QThreadPool pool;
+        PluginInfo *results = infos.data();
+        for (qsizetype i = 0; i < plugins.size(); ++i) {
+            pool.start([&plugins, results, i] {
+                results[i] = readPlugin(plugins.at(i));
+            });
+        }
+        pool.waitForDone();
+    }
+
     int retval = 0;
-    const QStringList positionalArguments = parser.positionalArguments();
-    for (const QString &plugin : positionalArguments) {
-        QByteArray pluginNativeName = QFile::encodeName(QDir::toNativeSeparators(plugin));
-        if (!QFile::exists(plugin)) {
-            std::cerr << "qtplugininfo: " << pluginNativeName.constData() << ": No such file or directory." << std::endl;
-            retval = 1;
+    QJsonObject combined;
+    for (qsizetype i = 0; i < plugins.size(); ++i) {
+        const PluginInfo &info = infos.at(i);
+        if (info.skipped)
             continue;
-        }
-        if (!QLibrary::isLibrary(plugin)) {
-            std::cerr << "qtplugininfo: " << pluginNativeName.constData() << ": Not a plug-in." << std::endl;
+
+        const QString nativeName = QDir::toNativeSeparators(plugins.at(i).path);
+        QByteArray pluginNativeName = QFile::encodeName(nativeName);
+        if (!info.error.isEmpty()) {
+            std::cerr << "qtplugininfo: " << pluginNativeName.constData() << ": "
+                      << qPrintable(info.error) << std::endl;
             retval = 1;
             continue;
         }
 
-        QPluginLoader loader(plugin);
-        QJsonObject metaData = loader.metaData();
-        if (metaData.isEmpty()) {
-            std::cerr << "qtplugininfo: " << pluginNativeName.constData() << ": No plug-in meta-data found: "
-                      << qPrintable(loader.errorString()) << std::endl;
-            retval = 1;
+        const QJsonObject &metaData = info.metaData;
+        if (combinedJson) {
+            combined.insert(nativeName, metaData);
             continue;
         }
 
@@ -94,27 +203,7 @@ int main(int argc, char** argv)
         int version = metaData.value("version").toInt();
         QJsonValue userData = metaData.value("MetaData");
 
-        if ((version >> 16) != (QT_VERSION >> 16)) {
-            std::cerr << "qtplugininfo: " << pluginNativeName.constData()
-                      << ": Qt version mismatch - got major version " << (version >> 16)
-                      << ", expected " << (QT_VERSION >> 16) << std::endl;
-            retval = 1;
-            continue;
-        }
-        if (iid.isEmpty() || className.isEmpty() || debug.isNull()) {
-            std::cerr << "qtplugininfo: " << pluginNativeName.constData() << ": invalid metadata, missing required fields:";
-            if (iid.isEmpty())
-                std::cerr << " iid";
-            if (className.isEmpty())
-                std::cerr << " className";
-            if (debug.isNull())
-                std::cerr << " debug";
-            std::cerr << std::endl;
-            retval = 1;
-            continue;
-        }
-
-        if (parser.positionalArguments().size() != 1)
+        if (plugins.size() != 1 || plugins.at(i).fromDirectory)
             std::cout << pluginNativeName.constData() << ": ";
         if (fullJson) {
             std::cout << QJsonDocument(metaData).toJson(jsonFormat).constData();
@@ -140,5 +229,11 @@ int main(int argc, char** argv)
         }
     }
 
+    if (combinedJson) {
+        std::cout << QJsonDocument(combined).toJson(jsonFormat).constData();
+        if (jsonFormat == QJsonDocument::Compact)
+            std::cout << std::endl;
+    }
+
     return retval;
 }
@@ -32,6 +32,8 @@
 #include <QtCore/qdir.h>
 #include <QtCore/qlibraryinfo.h>
 
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
 typedef QMap<QString, bool> widget_map;
@@ -539,6 +541,22 @@ public:
     void setupWidgetMap() const;
 };
 
+class QUiFormTemplatePrivate : public QSharedData
+{
+public:
+#ifdef QFORMINTERNAL_NAMESPACE
+    using DomUI = QFormInternal::DomUI;
+    using PropertyValueCache = QFormInternal::QFormBuilderExtra::PropertyValueCache;
+#else
+    using PropertyValueCache = QFormBuilderExtra::PropertyValueCache;
+#endif
+
+    std::unique_ptr<DomUI> ui;
+    // Property values converted while loading the form, relative to workingDirectory
+    PropertyValueCache propertyValues;
+    QDir workingDirectory;
+};
+
 void QUiLoaderPrivate::setupWidgetMap() const
 {
     if (!g_widgets()->isEmpty())
@@ -659,6 +677,69 @@ QWidget *QUiLoader::load(QIODevice *device, QWidget *parentWidget)
     return d->builder.load(device, parentWidget);
 }
 
+/*!
+    \since 6.8
+
+    Reads a form from the given \a device into a template that can be
+    instantiated repeatedly with load(), without parsing the UI file again.
+
+    Returns an invalid template if the form could not be read.
+
+    \sa errorString(), QUiFormTemplate
+*/
+QUiFormTemplate QUiLoader::compile(QIODevice *device)
+{
+    Q_D(QUiLoader);
+    // QXmlStreamReader will report errors on open failure.
+    if (!device->isOpen())
+        device->open(QIODevice::ReadOnly|QIODevice::Text);
+    QUiFormTemplate result;
+    if (auto *ui = d->builder.d->readUi(device)) {
+        result.d = new QUiFormTemplatePrivate;
+        result.d->ui.reset(ui);
+    }
+    return result;
+}
+
+/*!
+    \since 6.8
+    \overload
+
+    Creates a new widget with the given \a parentWidget from the form stored
+    in \a formTemplate.
+
+    Property values are converted from their UI file representation only the
+    first time the template is loaded, and reused for the following widgets.
+    The widgets themselves are still created through createWidget(),
+    createLayout(), createAction() and createActionGroup().
+
+    \sa compile(), errorString()
+*/
+QWidget *QUiLoader::load(const QUiFormTemplate &formTemplate, QWidget *parentWidget)
+{
+    Q_D(QUiLoader);
+    auto *extra = d->builder.d.data();
+    QUiFormTemplatePrivate *templateData = formTemplate.d.data();
+    if (!templateData) {
+        extra->m_errorString = extra->msgInvalidUiFile();
+        return nullptr;
+    }
+
+    // Icons and pixmaps are resolved relative to the working directory
+    if (templateData->workingDirectory != extra->m_workingDirectory) {
+        templateData->propertyValues.clear();
+        templateData->workingDirectory = extra->m_workingDirectory;
+    }
+
+    extra->m_errorString.clear();
+    extra->m_propertyValueCache = &templateData->propertyValues;
+    QWidget *widget = d->builder.create(templateData->ui.get(), parentWidget);
+    extra->m_propertyValueCache = nullptr;
+    if (!widget && extra->m_errorString.isEmpty())
+        extra->m_errorString = extra->msgInvalidUiFile();
+    return widget;
+}
+
 /*!
     Returns a list naming the paths in which the loader will search when
     locating custom widget plugins.
@@ -912,6 +993,69 @@ QString QUiLoader::errorString() const
     return d->builder.errorString();
 }
 
+/*!
+    \class QUiFormTemplate
+    \inmodule QtUiTools
+    \since 6.8
+
+    \brief The QUiFormTemplate class holds a parsed UI file that can be
+    instantiated repeatedly.
+
+    Use QUiLoader::compile() to create a template and
+    QUiLoader::load(const QUiFormTemplate &, QWidget *) to create widgets
+    from it. This avoids reading and parsing the XML of forms that are
+    created many times, for example in item delegates or dialog pools.
+
+    QUiFormTemplate is explicitly shared. Templates must only be used from
+    the thread in which widgets are created.
+
+    \sa QUiLoader
+*/
+
+/*!
+    Constructs an invalid template.
+*/
+QUiFormTemplate::QUiFormTemplate() noexcept = default;
+
+/*!
+    Constructs a copy of \a other.
+*/
+QUiFormTemplate::QUiFormTemplate(const QUiFormTemplate &other) noexcept = default;
+
+/*!
+    Move-constructs a template from \a other.
+*/
+QUiFormTemplate::QUiFormTemplate(QUiFormTemplate &&other) noexcept = default;
+
+/*!
+    Assigns \a other to this template.
+*/
+QUiFormTemplate &QUiFormTemplate::operator=(const QUiFormTemplate &other) noexcept = default;
+
+/*!
+    Move-assigns \a other to this template.
+*/
+QUiFormTemplate &QUiFormTemplate::operator=(QUiFormTemplate &&other) noexcept = default;
+
+/*!
+    Destroys the template.
+*/
+QUiFormTemplate::~QUiFormTemplate() = default;
+
+/*!
+    \fn void QUiFormTemplate::swap(QUiFormTemplate &other)
+
+    Swaps this template with \a other.
+*/
+
+/*!
+    Returns \c true if the template holds a form that was read successfully.
+*/
+bool QUiFormTemplate::isValid() const noexcept
+{
+    return bool(d);
+}
+
 QT_END_NAMESPACE
 
 #include "quiloader.moc"
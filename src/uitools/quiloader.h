@@ -7,6 +7,7 @@
 #include <QtUiTools/qtuitoolsglobal.h>
 #include <QtCore/qobject.h>
 #include <QtCore/qscopedpointer.h>
+#include <QtCore/qshareddata.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -18,6 +19,28 @@ class QString;
 class QIODevice;
 class QDir;
 
+class QUiFormTemplatePrivate;
+class Q_UITOOLS_EXPORT QUiFormTemplate
+{
+public:
+    QUiFormTemplate() noexcept;
+    QUiFormTemplate(const QUiFormTemplate &other) noexcept;
+    QUiFormTemplate(QUiFormTemplate &&other) noexcept;
+    QUiFormTemplate &operator=(const QUiFormTemplate &other) noexcept;
+    QUiFormTemplate &operator=(QUiFormTemplate &&other) noexcept;
+    ~QUiFormTemplate();
+
+    void swap(QUiFormTemplate &other) noexcept { d.swap(other.d); }
+
+    bool isValid() const noexcept;
+
+private:
+    friend class QUiLoader;
+    QExplicitlySharedDataPointer<QUiFormTemplatePrivate> d;
+};
+
+Q_DECLARE_SHARED(QUiFormTemplate)
+
 class QUiLoaderPrivate;
 class Q_UITOOLS_EXPORT QUiLoader : public QObject
 {
@@ -31,6 +54,8 @@ public:
     void addPluginPath(const QString &path);
 
     QWidget *load(QIODevice *device, QWidget *parentWidget = nullptr);
+    QUiFormTemplate compile(QIODevice *device);
+    QWidget *load(const QUiFormTemplate &formTemplate, QWidget *parentWidget = nullptr);
     QStringList availableWidgets() const;
     QStringList availableLayouts() const;
 
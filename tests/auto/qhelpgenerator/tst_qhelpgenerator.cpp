@@ -24,6 +24,7 @@ private:
     void checkFilters();
     void checkIndices();
     void checkFiles();
+    void checkFileData();
     void checkMetaData();
 
     QString m_outputFile;
@@ -66,6 +67,7 @@ void tst_QHelpGenerator::generateHelp()
         checkFilters();
         checkIndices();
         checkFiles();
+        checkFileData();
         checkMetaData();
 
         m_query->clear();
@@ -123,7 +125,7 @@ void tst_QHelpGenerator::checkFiles()
 {
     m_query->exec("SELECT COUNT(a.FileId) FROM FileNameTable a, FolderTable b "
         "WHERE a.FolderId=b.Id AND b.Name=\'testFolder\'");
-    if (!m_query->next() || m_query->value(0).toInt() != 6)
+    if (!m_query->next() || m_query->value(0).toInt() != 7)
         QFAIL("File Error!");
 
     QStringList lst;
@@ -152,6 +154,31 @@ void tst_QHelpGenerator::checkFiles()
     QVERIFY(fileAtts.value(2).contains("filter2"));
 }
 
+void tst_QHelpGenerator::checkFileData()
+{
+    m_query->exec("SELECT COUNT(*) FROM FileDataTable");
+    if (!m_query->next())
+        QFAIL("File Data Error!");
+    QCOMPARE(m_query->value(0).toInt(), 8);
+
+    // classic.css and sub/classic.css have identical contents
+    m_query->exec("SELECT COUNT(*) FROM FileBlobTable");
+    if (!m_query->next())
+        QFAIL("File Data Error!");
+    QCOMPARE(m_query->value(0).toInt(), 7);
+
+    QByteArray data[2];
+    m_query->exec("SELECT a.Data FROM FileDataTable a, FileNameTable b "
+        "WHERE a.Id=b.FileId AND b.Name LIKE \'%classic.css\'");
+    for (QByteArray &d : data) {
+        if (!m_query->next())
+            QFAIL("File Data Error!");
+        d = qUncompress(m_query->value(0).toByteArray());
+    }
+    QVERIFY(!data[0].isEmpty());
+    QCOMPARE(data[0], data[1]);
+}
+
 void tst_QHelpGenerator::checkMetaData()
 {
     m_query->exec("SELECT COUNT(Value) FROM MetaDataTable");
@@ -124,6 +124,25 @@ void tst_QHelpIndexModel::filter()
 
     m->filter("qmake");
     QCOMPARE(m->stringList().size(), 11);
+
+    // typing character by character narrows the previous result
+    m->filter("q");
+    m->filter("qm");
+    m->filter("qmak");
+    m->filter("qmake");
+    QCOMPARE(m->stringList().size(), 11);
+
+    m->filter("QMake");
+    QCOMPARE(m->stringList().size(), 11);
+
+    m->filter("foo");
+    QCOMPARE(m->stringList().size(), 2);
+
+    m->filter("fo");
+    QCOMPARE(m->stringList().size(), 3);
+
+    m->filter({});
+    QCOMPARE(m->stringList().size(), 19);
 }
 
 QTEST_MAIN(tst_QHelpIndexModel)
@@ -1,13 +1,16 @@
 // Copyright (C) 2016 The Qt Company Ltd.
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
 
+#include <QtCore/qdatetime.h>
 #include <QtCore/qdir.h>
 #include <QtCore/qdebug.h>
 #include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
 #include <QtCore/qbytearray.h>
 #include <QtCore/qjsondocument.h>
 #include <QtCore/qlibraryinfo.h>
 #include <QtCore/qprocess.h>
+#include <QtCore/qtemporarydir.h>
 
 #include <QtTest/qtest.h>
 
@@ -20,9 +23,12 @@ public:
 private slots:
     void test_data();
     void test();
+    void cache();
+    void cacheInvalidation();
 
 private:
     void readExpectedFile(const QString &baseDir, const QString &fileName, QByteArray *content);
+    void runScanner(const QStringList &arguments, QByteArray *stdOut, QByteArray *stdErr);
 
     QString m_cmd;
     QString m_basePath;
@@ -130,5 +136,116 @@ void tst_qtattributionsscanner::test()
     }
 }
 
+void tst_qtattributionsscanner::runScanner(const QStringList &arguments, QByteArray *stdOut,
+                                           QByteArray *stdErr)
+{
+    QProcess proc;
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert("QT_ATTRIBUTIONSSCANNER_TEST", "1");
+    proc.setProcessEnvironment(env);
+    proc.start(m_cmd, arguments, QIODevice::ReadWrite | QIODevice::Text);
+
+    const QString command = m_cmd + ' ' + arguments.join(' ');
+    QVERIFY2(proc.waitForStarted(), qPrintable(command + QLatin1String(" :") + proc.errorString()));
+    QVERIFY2(proc.waitForFinished(30000), qPrintable(command));
+    QVERIFY2(proc.exitStatus() == QProcess::NormalExit && proc.exitCode() == 0,
+             qPrintable(command));
+    *stdOut = proc.readAllStandardOutput();
+    *stdErr = proc.readAllStandardError();
+}
+
+void tst_qtattributionsscanner::cache()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString dir = QDir(m_basePath).absoluteFilePath("good");
+    const QStringList arguments{dir, "--output-format", "json",
+                                "--cache", tempDir.filePath("cache")};
+
+    QByteArray stdOut;
+    QByteArray stdErr;
+    runScanner(arguments, &stdOut, &stdErr);
+    if (QTest::currentTestFailed())
+        return;
+    QVERIFY(QFile::exists(tempDir.filePath("cache")));
+
+    // The second run is served from the cache and must produce the same output
+    QByteArray cachedStdOut;
+    QByteArray cachedStdErr;
+    runScanner(arguments, &cachedStdOut, &cachedStdErr);
+    if (QTest::currentTestFailed())
+        return;
+    QCOMPARE(cachedStdErr, stdErr);
+    QCOMPARE(QJsonDocument::fromJson(cachedStdOut), QJsonDocument::fromJson(stdOut));
+
+    QByteArray expectedOutput;
+    readExpectedFile(dir, "good/expected.json", &expectedOutput);
+    QCOMPARE(QJsonDocument::fromJson(cachedStdOut), QJsonDocument::fromJson(expectedOutput));
+}
+
+static bool writeFile(const QString &filePath, const QByteArray &contents,
+                      const QDateTime &modificationTime)
+{
+    QFile file(filePath);
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+            && file.write(contents) == contents.size()
+            && file.setFileTime(modificationTime, QFileDevice::FileModificationTime);
+}
+
+void tst_qtattributionsscanner::cacheInvalidation()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QDir sourceDir(QDir(m_basePath).absoluteFilePath("good/variants"));
+    const QDir inputDir(tempDir.filePath("variants"));
+    QVERIFY(QDir().mkpath(inputDir.path()));
+    for (const QString &fileName : { "qt_attribution_test.json", "COPYRIGHT.txt", "LICENSE1.txt",
+                                     "LICENSE2.txt" }) {
+        QVERIFY(QFile::copy(sourceDir.filePath(fileName), inputDir.filePath(fileName)));
+        QVERIFY(QFile::setPermissions(inputDir.filePath(fileName),
+                                      QFileDevice::ReadOwner | QFileDevice::WriteOwner));
+    }
+
+    const QString attributionFile = inputDir.filePath("qt_attribution_test.json");
+    const QString licenseFile = inputDir.filePath("LICENSE1.txt");
+    const QDateTime attributionTime = QFileInfo(attributionFile).lastModified();
+    const QStringList arguments{inputDir.path(), "--output-format", "qdoc",
+                                "--cache", tempDir.filePath("cache")};
+
+    QByteArray stdOut;
+    QByteArray stdErr;
+    runScanner(arguments, &stdOut, &stdErr);
+    if (QTest::currentTestFailed())
+        return;
+    QVERIFY(stdOut.contains("Variants Test"));
+    QVERIFY(stdOut.contains("LICENSE1"));
+
+    // A change that keeps the modification time is not noticed, which shows
+    // that the result came from the cache
+    QFile original(attributionFile);
+    QVERIFY(original.open(QIODevice::ReadOnly));
+    QByteArray attribution = original.readAll();
+    original.close();
+    attribution.replace("Variants Test", "Renamed Test");
+    QVERIFY(writeFile(attributionFile, attribution, attributionTime));
+
+    runScanner(arguments, &stdOut, &stdErr);
+    if (QTest::currentTestFailed())
+        return;
+    QVERIFY(stdOut.contains("Variants Test"));
+    QVERIFY(!stdOut.contains("Renamed Test"));
+
+    // Modifying a license file read for the package invalidates its cache entry
+    QVERIFY(writeFile(licenseFile, "CHANGED LICENSE",
+                      QFileInfo(licenseFile).lastModified().addSecs(10)));
+
+    runScanner(arguments, &stdOut, &stdErr);
+    if (QTest::currentTestFailed())
+        return;
+    QVERIFY(stdOut.contains("CHANGED LICENSE"));
+    QVERIFY(!stdOut.contains("LICENSE1"));
+    QVERIFY(stdOut.contains("Renamed Test"));
+}
+
 QTEST_MAIN(tst_qtattributionsscanner)
 #include "tst_qtattributionsscanner.moc"
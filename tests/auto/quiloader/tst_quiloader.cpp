@@ -0,0 +1,153 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+#include <QtTest/QtTest>
+
+#include <QtCore/QBuffer>
+#include <QtWidgets/QAbstractButton>
+#include <QtWidgets/QLabel>
+#include <QtWidgets/QLayout>
+#include <QtWidgets/QLineEdit>
+#include <QtWidgets/QWidget>
+#include <QtUiTools/QUiLoader>
+
+#include <memory>
+
+using namespace Qt::StringLiterals;
+
+static const char formData[] = R"(<?xml version="1.0" encoding="UTF-8"?>
+<ui version="4.0">
+ <class>Form</class>
+ <widget class="QWidget" name="Form">
+  <property name="geometry">
+   <rect>
+    <x>0</x>
+    <y>0</y>
+    <width>320</width>
+    <height>200</height>
+   </rect>
+  </property>
+  <property name="windowTitle">
+   <string>Template Form</string>
+  </property>
+  <layout class="QVBoxLayout" name="verticalLayout">
+   <item>
+    <widget class="QLabel" name="label">
+     <property name="text">
+      <string>Name:</string>
+     </property>
+    </widget>
+   </item>
+   <item>
+    <widget class="QLineEdit" name="lineEdit">
+     <property name="placeholderText">
+      <string>Enter a name</string>
+     </property>
+    </widget>
+   </item>
+   <item>
+    <widget class="QPushButton" name="pushButton">
+     <property name="text">
+      <string>OK</string>
+     </property>
+     <property name="checkable">
+      <bool>true</bool>
+     </property>
+    </widget>
+   </item>
+  </layout>
+ </widget>
+</ui>
+)";
+
+// Describes the object tree of a form, one line per object
+static void dumpTree(const QObject *object, int depth, QStringList *result)
+{
+    QString line = QString(depth * 2, u' ') + QLatin1StringView(object->metaObject()->className())
+            + u' ' + object->objectName();
+    if (auto *widget = qobject_cast<const QWidget *>(object)) {
+        line += u" title="_s + widget->windowTitle();
+        if (widget->isWindow()) {
+            line += u" size="_s + QString::number(widget->width()) + u'x'
+                    + QString::number(widget->height());
+        }
+    }
+    if (auto *label = qobject_cast<const QLabel *>(object))
+        line += u" text="_s + label->text();
+    if (auto *lineEdit = qobject_cast<const QLineEdit *>(object))
+        line += u" placeholder="_s + lineEdit->placeholderText();
+    if (auto *button = qobject_cast<const QAbstractButton *>(object)) {
+        line += u" text="_s + button->text() + u" checkable="_s
+                + (button->isCheckable() ? u"true"_s : u"false"_s);
+    }
+    if (auto *layout = qobject_cast<const QLayout *>(object))
+        line += u" count="_s + QString::number(layout->count());
+    result->append(line);
+
+    for (const QObject *child : object->children())
+        dumpTree(child, depth + 1, result);
+}
+
+static QStringList dumpTree(const QWidget *widget)
+{
+    QStringList result;
+    dumpTree(widget, 0, &result);
+    return result;
+}
+
+class tst_QUiLoader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void compileAndLoad();
+    void invalidTemplate();
+};
+
+void tst_QUiLoader::compileAndLoad()
+{
+    QUiLoader loader;
+
+    QBuffer directBuffer;
+    directBuffer.setData(formData);
+    std::unique_ptr<QWidget> direct(loader.load(&directBuffer));
+    QVERIFY2(direct, qPrintable(loader.errorString()));
+    const QStringList expected = dumpTree(direct.get());
+
+    QBuffer templateBuffer;
+    templateBuffer.setData(formData);
+    const QUiFormTemplate formTemplate = loader.compile(&templateBuffer);
+    QVERIFY(formTemplate.isValid());
+
+    // The property values are converted by the first load and reused by the second
+    std::unique_ptr<QWidget> first(loader.load(formTemplate));
+    QVERIFY2(first, qPrintable(loader.errorString()));
+    QCOMPARE(dumpTree(first.get()), expected);
+
+    std::unique_ptr<QWidget> second(loader.load(formTemplate));
+    QVERIFY2(second, qPrintable(loader.errorString()));
+    QCOMPARE(dumpTree(second.get()), expected);
+
+    // The widgets are independent of each other
+    QVERIFY(first->findChild<QLineEdit *>(u"lineEdit"_s)
+            != second->findChild<QLineEdit *>(u"lineEdit"_s));
+    first->findChild<QLabel *>(u"label"_s)->setText(u"Changed"_s);
+    QCOMPARE(second->findChild<QLabel *>(u"label"_s)->text(), u"Name:"_s);
+}
+
+void tst_QUiLoader::invalidTemplate()
+{
+    QUiLoader loader;
+
+    QVERIFY(!QUiFormTemplate().isValid());
+
+    QBuffer buffer;
+    buffer.setData("<ui version=\"4.0\"><widget class=\"QWidget\"");
+    const QUiFormTemplate formTemplate = loader.compile(&buffer);
+    QVERIFY(!formTemplate.isValid());
+
+    QVERIFY(!loader.load(formTemplate));
+    QVERIFY(!loader.errorString().isEmpty());
+}
+
+QTEST_MAIN(tst_QUiLoader)
+#include "tst_quiloader.moc"
@@ -0,0 +1,318 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+#include <QtTest/QtTest>
+
+#include <QtDesigner/QDesignerComponents>
+#include <QtDesigner/abstractformeditor.h>
+#include <QtDesigner/abstractformwindow.h>
+#include <QtDesigner/abstractformwindowmanager.h>
+#include <QtDesigner/abstractpropertyeditor.h>
+#include <QtDesigner/formbuilder.h>
+#include <QtDesigner/propertysheet.h>
+#include <QtDesigner/qextensionmanager.h>
+#include <QtDesigner/private/ui4_p.h>
+
+#include <QtWidgets/QCheckBox>
+#include <QtWidgets/QLabel>
+#include <QtWidgets/QLineEdit>
+#include <QtWidgets/QPushButton>
+#include <QtWidgets/QSpinBox>
+
+#include <QtCore/QBuffer>
+#include <QtCore/QXmlStreamReader>
+#include <QtCore/QXmlStreamWriter>
+
+#include <memory>
+
+using namespace Qt::StringLiterals;
+
+// Shape of a synthetic form: Each container has 'breadth' child containers
+// (up to 'depth' levels) and 'leaves' leaf widgets carrying
+// 'customProperties' dynamic properties each.
+struct FormSpec
+{
+    int depth = 1;
+    int breadth = 1;
+    int leaves = 1;
+    int customProperties = 0;
+};
+
+Q_DECLARE_METATYPE(FormSpec)
+
+class FormGenerator
+{
+public:
+    explicit FormGenerator(const FormSpec &spec) : m_spec(spec) {}
+
+    QByteArray generate();
+
+private:
+    void writeContainer(int level);
+    void writeLeaf();
+    void writeProperty(const QString &name, const QString &type, const QString &value,
+                       bool stdset = true);
+    QString nextName(QLatin1StringView prefix) { return prefix + QString::number(m_count++); }
+
+    const FormSpec m_spec;
+    QXmlStreamWriter m_writer;
+    int m_count = 0;
+};
+
+QByteArray FormGenerator::generate()
+{
+    QByteArray result;
+    QBuffer buffer(&result);
+    buffer.open(QIODevice::WriteOnly);
+    m_writer.setDevice(&buffer);
+    m_writer.setAutoFormatting(true);
+    m_writer.setAutoFormattingIndent(1);
+    m_count = 0;
+
+    m_writer.writeStartDocument();
+    m_writer.writeStartElement("ui"_L1);
+    m_writer.writeAttribute("version"_L1, "4.0"_L1);
+    m_writer.writeTextElement("class"_L1, "Form"_L1);
+    m_writer.writeStartElement("widget"_L1);
+    m_writer.writeAttribute("class"_L1, "QWidget"_L1);
+    m_writer.writeAttribute("name"_L1, "Form"_L1);
+    writeContainer(0);
+    m_writer.writeEndElement(); // widget
+    m_writer.writeEndElement(); // ui
+    m_writer.writeEndDocument();
+    return result;
+}
+
+void FormGenerator::writeContainer(int level)
+{
+    m_writer.writeStartElement("layout"_L1);
+    m_writer.writeAttribute("class"_L1, level % 2 ? "QHBoxLayout"_L1 : "QVBoxLayout"_L1);
+    m_writer.writeAttribute("name"_L1, nextName("layout_"_L1));
+    if (level < m_spec.depth) {
+        for (int i = 0; i < m_spec.breadth; ++i) {
+            m_writer.writeStartElement("item"_L1);
+            m_writer.writeStartElement("widget"_L1);
+            m_writer.writeAttribute("class"_L1, "QGroupBox"_L1);
+            const QString name = nextName("groupBox_"_L1);
+            m_writer.writeAttribute("name"_L1, name);
+            writeProperty("title"_L1, "string"_L1, name);
+            writeContainer(level + 1);
+            m_writer.writeEndElement(); // widget
+            m_writer.writeEndElement(); // item
+        }
+    }
+    for (int i = 0; i < m_spec.leaves; ++i) {
+        m_writer.writeStartElement("item"_L1);
+        writeLeaf();
+        m_writer.writeEndElement(); // item
+    }
+    m_writer.writeEndElement(); // layout
+}
+
+void FormGenerator::writeLeaf()
+{
+    static const QLatin1StringView classes[] = {
+        "QLabel"_L1, "QLineEdit"_L1, "QPushButton"_L1, "QSpinBox"_L1, "QCheckBox"_L1
+    };
+    const QLatin1StringView className = classes[m_count % std::size(classes)];
+    const QString name = nextName("widget_"_L1);
+
+    m_writer.writeStartElement("widget"_L1);
+    m_writer.writeAttribute("class"_L1, className);
+    m_writer.writeAttribute("name"_L1, name);
+    if (className == "QSpinBox"_L1) {
+        writeProperty("maximum"_L1, "number"_L1, "1000"_L1);
+    } else {
+        writeProperty("text"_L1, "string"_L1, name);
+        if (className == "QPushButton"_L1 || className == "QCheckBox"_L1)
+            writeProperty("checkable"_L1, "bool"_L1, "true"_L1);
+    }
+    writeProperty("toolTip"_L1, "string"_L1, "Tool tip of "_L1 + name);
+    for (int p = 0; p < m_spec.customProperties; ++p)
+        writeProperty("customProperty"_L1 + QString::number(p), "string"_L1, name, false);
+    m_writer.writeEndElement(); // widget
+}
+
+void FormGenerator::writeProperty(const QString &name, const QString &type,
+                                  const QString &value, bool stdset)
+{
+    m_writer.writeStartElement("property"_L1);
+    m_writer.writeAttribute("name"_L1, name);
+    if (!stdset)
+        m_writer.writeAttribute("stdset"_L1, "0"_L1);
+    m_writer.writeTextElement(type, value);
+    m_writer.writeEndElement();
+}
+
+// Exposes the creation from a DomUI
+class FormBuilder : public QFormBuilder
+{
+public:
+    using QFormBuilder::create;
+};
+
+static std::unique_ptr<DomUI> readDomUi(const QByteArray &contents)
+{
+    QXmlStreamReader reader(contents);
+    while (!reader.atEnd() && reader.readNext() != QXmlStreamReader::StartElement) {
+    }
+    auto ui = std::make_unique<DomUI>();
+    ui->read(reader);
+    if (reader.hasError())
+        return {};
+    return ui;
+}
+
+class tst_Bench_Designer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void domUiRead_data() { formData(); }
+    void domUiRead();
+    void formBuilderCreate_data() { formData(); }
+    void formBuilderCreate();
+    void designerLoad_data() { formData(); }
+    void designerLoad();
+    void designerSave_data() { formData(); }
+    void designerSave();
+    void propertySheetCreation();
+    void propertyEditorSetObject();
+
+private:
+    void formData();
+    QDesignerFormWindowInterface *createFormWindow(const QByteArray &contents);
+
+    QDesignerFormEditorInterface *m_core = nullptr;
+    QDesignerPropertyEditorInterface *m_propertyEditor = nullptr;
+};
+
+void tst_Bench_Designer::initTestCase()
+{
+    m_core = QDesignerComponents::createFormEditor(this);
+    QDesignerComponents::initializeResources();
+    QDesignerComponents::initializePlugins(m_core);
+    m_propertyEditor = QDesignerComponents::createPropertyEditor(m_core, nullptr);
+    m_core->setPropertyEditor(m_propertyEditor);
+}
+
+void tst_Bench_Designer::cleanupTestCase()
+{
+    delete m_propertyEditor;
+    m_propertyEditor = nullptr;
+}
+
+void tst_Bench_Designer::formData()
+{
+    QTest::addColumn<FormSpec>("spec");
+
+    QTest::newRow("small") << FormSpec{1, 2, 10, 0};
+    QTest::newRow("deep") << FormSpec{12, 1, 4, 0};
+    QTest::newRow("wide") << FormSpec{4, 4, 10, 0};
+    QTest::newRow("custom-properties") << FormSpec{2, 4, 10, 20};
+}
+
+QDesignerFormWindowInterface *tst_Bench_Designer::createFormWindow(const QByteArray &contents)
+{
+    QDesignerFormWindowInterface *formWindow = m_core->formWindowManager()->createFormWindow();
+    if (!contents.isEmpty() && !formWindow->setContents(QString::fromUtf8(contents))) {
+        delete formWindow;
+        return nullptr;
+    }
+    return formWindow;
+}
+
+void tst_Bench_Designer::domUiRead()
+{
+    QFETCH(FormSpec, spec);
+    const QByteArray contents = FormGenerator(spec).generate();
+    QVERIFY(readDomUi(contents));
+
+    QBENCHMARK {
+        readDomUi(contents);
+    }
+}
+
+void tst_Bench_Designer::formBuilderCreate()
+{
+    QFETCH(FormSpec, spec);
+    const std::unique_ptr<DomUI> ui = readDomUi(FormGenerator(spec).generate());
+    QVERIFY(ui);
+
+    FormBuilder builder;
+    QBENCHMARK {
+        QWidget *widget = builder.create(ui.get(), nullptr);
+        QVERIFY(widget);
+        delete widget;
+    }
+}
+
+void tst_Bench_Designer::designerLoad()
+{
+    QFETCH(FormSpec, spec);
+    const QString contents = QString::fromUtf8(FormGenerator(spec).generate());
+    std::unique_ptr<QDesignerFormWindowInterface> formWindow(createFormWindow({}));
+
+    QBENCHMARK {
+        QVERIFY(formWindow->setContents(contents));
+    }
+}
+
+void tst_Bench_Designer::designerSave()
+{
+    QFETCH(FormSpec, spec);
+    std::unique_ptr<QDesignerFormWindowInterface>
+        formWindow(createFormWindow(FormGenerator(spec).generate()));
+    QVERIFY(formWindow);
+
+    QBENCHMARK {
+        const QString contents = formWindow->contents();
+        QVERIFY(!contents.isEmpty());
+    }
+}
+
+void tst_Bench_Designer::propertySheetCreation()
+{
+    QExtensionManager *extensionManager = m_core->extensionManager();
+    QBENCHMARK {
+        QWidget parent;
+        for (int i = 0; i < 100; ++i) {
+            const QWidget *widgets[] = {
+                new QLabel(&parent), new QLineEdit(&parent), new QPushButton(&parent),
+                new QSpinBox(&parent), new QCheckBox(&parent)
+            };
+            for (const QWidget *widget : widgets) {
+                auto *sheet = qt_extension<QDesignerPropertySheetExtension *>(
+                    extensionManager, const_cast<QWidget *>(widget));
+                QVERIFY(sheet);
+            }
+        }
+    }
+}
+
+void tst_Bench_Designer::propertyEditorSetObject()
+{
+    std::unique_ptr<QDesignerFormWindowInterface>
+        formWindow(createFormWindow(FormGenerator(FormSpec{2, 4, 10, 5}).generate()));
+    QVERIFY(formWindow);
+
+    QWidgetList widgets;
+    const auto children = formWindow->mainContainer()->findChildren<QWidget *>();
+    for (QWidget *child : children) {
+        if (formWindow->isManaged(child))
+            widgets.append(child);
+    }
+    QVERIFY(widgets.size() > 100);
+    widgets.resize(100);
+
+    QBENCHMARK {
+        for (QWidget *widget : std::as_const(widgets))
+            m_propertyEditor->setObject(widget);
+    }
+    m_propertyEditor->setObject(nullptr);
+}
+
+QTEST_MAIN(tst_Bench_Designer)
+#include "tst_bench_designer.moc"